@@ -0,0 +1,49 @@
+
+// Measures the time spent by each kernel of the EntityIntegrator to integrate one axis of 10k, 100k and 1M entities (the
+// kernels not supported by the cpu are skipped).
+//
+
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+#include "entityIntegrator.hpp"
+
+using namespace mc2d;
+
+
+static constexpr int    WARMUP_STEPS_NUM = 10;
+static constexpr int    STEPS_NUM = 200;
+
+
+int main()
+{
+        const IntegrationKernel kernels[] = { IntegrationKernel::SCALAR, IntegrationKernel::SSE, IntegrationKernel::AVX };
+        const size_t counts[] = { 10'000, 100'000, 1'000'000 };
+
+        for(size_t num : counts)
+        {
+                for(IntegrationKernel kernel : kernels)
+                {
+                        if(!EntityIntegrator::setKernel(kernel))
+                                continue;
+
+                        std::vector<float> pos(num, 0.0f), vel(num, 1.0f), acc(num, 0.0f);
+                        for(int s = 0; s < WARMUP_STEPS_NUM; ++s)
+                                EntityIntegrator::integrate(pos.data(), vel.data(), acc.data(), num, 1.0f / 60.0f);
+
+                        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+                        for(int s = 0; s < STEPS_NUM; ++s)
+                        {
+                                acc[s % num] = 9.8f;            // Keep the velocities from reaching zero
+                                EntityIntegrator::integrate(pos.data(), vel.data(), acc.data(), num, 1.0f / 60.0f);
+                        }
+
+                        float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+                        std::printf("%9zu entities, %-6s kernel: %10.2f us per step (%.2f ns per entity)\n", num, EntityIntegrator::getKernelName(kernel),
+                                elapsed / STEPS_NUM, elapsed * 1000.0f / (STEPS_NUM * (float) num));
+                }
+        }
+
+        return 0;
+}
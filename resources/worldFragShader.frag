@@ -2,6 +2,7 @@
 
 in vec2 uv;
 in float tileId;
+in float lightLevel;
 
 uniform sampler2DArray tilesetArray;
 
@@ -10,4 +11,7 @@ out vec4 outColor;
 void main()
 {
         outColor = texture(tilesetArray, vec3(uv, tileId));
+
+        // Blocks in complete darkness are still barely visible
+        outColor.rgb *= mix(0.05f, 1.0f, lightLevel);
 }
@@ -3,11 +3,14 @@
 layout (location = 0) in vec2 inPos;
 layout (location = 1) in vec2 inUv;
 layout (location = 2) in float inTileId;
+layout (location = 3) in vec2 inLight;         // Sky light and block light levels (normalized in range [0, 1])
 
 uniform mat4 transformMatrix;
+uniform float skyLightFactor;                   // Scales the sky light according to the time of the day
 
 out vec2 uv;
 out float tileId;
+out float lightLevel;
 
 void main()
 {
@@ -15,4 +18,5 @@ void main()
 
         uv = inUv;
         tileId = inTileId;
+        lightLevel = max(inLight.x * skyLightFactor, inLight.y);
 }
@@ -0,0 +1,101 @@
+
+#include "allocationCounter.hpp"
+
+#include <new>
+#include <cstdlib>
+#include <cassert>
+
+namespace mc2d {
+
+
+#ifdef MC2D_COUNT_ALLOCATIONS
+        static thread_local uint64_t s_allocationsNum = 0;             // Allocations made by the thread
+#endif
+
+
+        // Returns the number of heap allocations made by the calling thread since it has been started
+        uint64_t AllocationCounter::getCount()
+        {
+#ifdef MC2D_COUNT_ALLOCATIONS
+                return s_allocationsNum;
+#else
+                return 0;
+#endif
+        }
+
+
+        // Starts checking the allocations made by the calling thread
+        // @name: name of the checked code
+        // @enabled: if false the scope does not check anything (used for the scopes that are not always on the hot path)
+        ZeroAllocationScope::ZeroAllocationScope(const char* name, bool enabled) : m_name(name), m_enabled(enabled), m_startCount(AllocationCounter::getCount())
+        {}
+
+
+        ZeroAllocationScope::~ZeroAllocationScope()
+        {
+                const uint64_t allocationsNum = AllocationCounter::getCount() - m_startCount;
+                if(m_enabled && allocationsNum != 0)
+                {
+                        logError("%s allocated memory %lu times on a path that must not allocate!", m_name, allocationsNum);
+                        assert(false);
+                }
+        }
+
+}
+
+
+#ifdef MC2D_COUNT_ALLOCATIONS
+
+// Replacements of the global allocation functions that count the allocations of each thread (the aligned versions are
+// used by the FrameArena when it is full)
+
+void* operator new(size_t bytes)
+{
+        ++mc2d::s_allocationsNum;
+        if(void* ptr = std::malloc(bytes == 0 ? 1 : bytes))
+                return ptr;
+
+        throw std::bad_alloc();
+}
+
+
+void* operator new[](size_t bytes)
+{
+        return operator new(bytes);
+}
+
+
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept
+{
+        ++mc2d::s_allocationsNum;
+        return std::malloc(bytes == 0 ? 1 : bytes);
+}
+
+
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept
+{
+        return operator new(bytes, std::nothrow);
+}
+
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+        ++mc2d::s_allocationsNum;
+        const size_t align = static_cast<size_t>(alignment);
+        if(void* ptr = std::aligned_alloc(align, bytes == 0 ? align : (bytes + align - 1) & ~(align - 1)))
+                return ptr;
+
+        throw std::bad_alloc();
+}
+
+
+void operator delete(void* ptr) noexcept                                { std::free(ptr); }
+void operator delete[](void* ptr) noexcept                              { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept                        { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept                      { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept         { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept       { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept              { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept      { std::free(ptr); }
+
+#endif
@@ -0,0 +1,57 @@
+
+// Contains definition of the AllocationCounter class and of the ZeroAllocationScope class, they are used (in debug
+// builds) to check that the hot paths of the game do not allocate memory from the heap.
+//
+// When the game is built with MC2D_COUNT_ALLOCATIONS defined (cmake -DMC2D_COUNT_ALLOCATIONS=ON) the global operator
+// new is replaced by one that counts the allocations made by each thread, Game::run() uses it to measure the allocations
+// of each frame. A ZeroAllocationScope checks that no allocation happens while it is alive (it reports an error and
+// asserts otherwise). In the other builds nothing is counted and the scopes do nothing.
+//
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+
+        class AllocationCounter {
+        public:
+                AllocationCounter() = delete;
+                ~AllocationCounter() = delete;
+
+                static uint64_t         getCount();
+
+                // Returns true if the allocations are counted (otherwise getCount() always returns zero)
+#ifdef MC2D_COUNT_ALLOCATIONS
+                static constexpr bool   isEnabled()                             { return true; }
+#else
+                static constexpr bool   isEnabled()                             { return false; }
+#endif
+        };
+
+
+        class ZeroAllocationScope {
+        public:
+                ZeroAllocationScope(const char* name, bool enabled = true);
+                ~ZeroAllocationScope();
+
+                // Turns the check on or off before the scope ends (used when the checked code turns out to do work that allocates)
+                inline void             setEnabled(bool enabled)                { m_enabled = enabled; }
+
+                // Delete copy constructors
+                ZeroAllocationScope(const ZeroAllocationScope& other) = delete;
+                ZeroAllocationScope&    operator = (const ZeroAllocationScope& other) = delete;
+
+        private:
+                const char*             m_name;                 // Name of the checked code (used in the error message)
+                bool                    m_enabled;
+                uint64_t                m_startCount;           // Allocations made by the thread when the scope has been entered
+        };
+
+}
+
+#endif // ALLOCATION_COUNTER_H
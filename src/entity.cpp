@@ -20,7 +20,11 @@ namespace mc2d {
                 m_velocity += deltaTimeInSec * m_acceleration;
                 m_pos += deltaTimeInSec * m_velocity;
 
-                m_velocity *= 0.9f;            // Simulate drag
+                m_velocity *= ENTITY_DRAG_FACTOR;      // Simulate drag
+
+                m_velocity.x = std::fabs(m_velocity.x) < ENTITY_MIN_VELOCITY ? 0.0f : m_velocity.x;
+                m_velocity.y = std::fabs(m_velocity.y) < ENTITY_MIN_VELOCITY ? 0.0f : m_velocity.y;
+                m_velocity.z = std::fabs(m_velocity.z) < ENTITY_MIN_VELOCITY ? 0.0f : m_velocity.z;
 
                 m_acceleration.x = 0.0f;
                 m_acceleration.y = 0.0f;
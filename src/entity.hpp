@@ -5,6 +5,7 @@
 #define ENTITY_H
 
 #include <fstream>
+#include <cmath>
 #include <glm/vec3.hpp>
 
 #include "log.hpp"
@@ -20,6 +21,17 @@ namespace mc2d {
         };
 
 
+        // Number of values in the EntityType enum
+        constexpr size_t ENTITY_TYPES_NUM = static_cast<size_t>(EntityType::CHICKEN) + 1;
+
+        // Drag applied to the velocity of the entities each update
+        constexpr float ENTITY_DRAG_FACTOR = 0.9f;
+
+        // Velocities (measured in blocks/second) smaller than this are set to zero, so that the drag does not keep
+        // shrinking them towards denormal values (that are very slow to compute with)
+        constexpr float ENTITY_MIN_VELOCITY = 1e-4f;
+
+
         class Entity {
         public:
                 Entity(const glm::vec3& pos, float health, EntityType entityType);
@@ -34,8 +46,8 @@ namespace mc2d {
                 inline void             setIsFacingRight(bool value)            { m_isFacingRight = value; }
 
                 inline const glm::vec3& getPos() const                          { return m_pos; }
-                inline const glm::vec3& getVelocity()                           { return m_velocity; }
-                inline const glm::vec3& getAcceleration()                       { return m_acceleration; }
+                inline const glm::vec3& getVelocity() const                     { return m_velocity; }
+                inline const glm::vec3& getAcceleration() const                 { return m_acceleration; }
                 inline float            getHealth() const                       { return m_health; }
                 inline const EntityType getType() const                         { return m_entityType; }
                 inline const bool       isFacingRight() const                   { return m_isFacingRight; }
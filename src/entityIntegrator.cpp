@@ -0,0 +1,195 @@
+
+#include "entityIntegrator.hpp"
+#include "entity.hpp"
+
+// The vectorized kernels are compiled for the x86 cpus (with the target attribute, so the rest of the game does not need
+// to be compiled with AVX enabled) and are used only if the cpu supports them
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        #define ENTITY_INTEGRATOR_X86
+        #include <immintrin.h>
+#endif
+
+namespace mc2d {
+
+
+        IntegrationKernel EntityIntegrator::s_kernel = EntityIntegrator::selectBestKernel();
+        EntityIntegrator::KernelFunction EntityIntegrator::s_kernelFunc = nullptr;
+
+
+        // Integrates velocity and position of a group of entities along one axis with the kernel in use
+        // @pos: positions of the entities
+        // @vel: velocities of the entities
+        // @acc: accelerations of the entities (reset to zero after the integration)
+        // @num: number of entities
+        // @deltaTime: time step (measured in seconds)
+        void EntityIntegrator::integrate(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                if(s_kernelFunc == nullptr)
+                        setKernel(s_kernel);
+
+                s_kernelFunc(pos, vel, acc, num, deltaTime);
+        }
+
+
+        // Checks if the given kernel can be used on this machine
+        // @kernel: the kernel to check
+        // @returns: true if the cpu supports the kernel, false otherwise
+        bool EntityIntegrator::isKernelSupported(IntegrationKernel kernel)
+        {
+                switch(kernel)
+                {
+                        case IntegrationKernel::SCALAR: return true;
+#ifdef ENTITY_INTEGRATOR_X86
+                        // Cpu features may be queried before the initialization done by the runtime (s_kernel is a static variable)
+                        case IntegrationKernel::SSE:    __builtin_cpu_init(); return __builtin_cpu_supports("sse2");
+                        case IntegrationKernel::AVX:    __builtin_cpu_init(); return __builtin_cpu_supports("avx");
+#endif
+                        default:                        return false;
+                }
+        }
+
+
+        // Changes the kernel used by integrate()
+        // @kernel: the kernel to use
+        // @returns: true if the kernel has been changed, false if the kernel is not supported by the cpu
+        bool EntityIntegrator::setKernel(IntegrationKernel kernel)
+        {
+                if(!isKernelSupported(kernel))
+                {
+                        logError("EntityIntegrator::setKernel() failed, the %s kernel is not supported on this machine!", getKernelName(kernel));
+                        return false;
+                }
+
+                switch(kernel)
+                {
+                        case IntegrationKernel::SSE:    s_kernelFunc = integrateSSE; break;
+                        case IntegrationKernel::AVX:    s_kernelFunc = integrateAVX; break;
+                        default:                        s_kernelFunc = integrateScalar; break;
+                }
+
+                s_kernel = kernel;
+                return true;
+        }
+
+
+        // Returns the kernel used by integrate()
+        IntegrationKernel EntityIntegrator::getKernel()
+        {
+                return s_kernel;
+        }
+
+
+        // Returns the name of the given kernel
+        const char* EntityIntegrator::getKernelName(IntegrationKernel kernel)
+        {
+                switch(kernel)
+                {
+                        case IntegrationKernel::SCALAR: return "scalar";
+                        case IntegrationKernel::SSE:    return "SSE";
+                        case IntegrationKernel::AVX:    return "AVX";
+                        default:                        return "unknown";
+                }
+        }
+
+
+        // Returns the fastest kernel supported by the cpu
+        IntegrationKernel EntityIntegrator::selectBestKernel()
+        {
+                if(isKernelSupported(IntegrationKernel::AVX))
+                        return IntegrationKernel::AVX;
+
+                if(isKernelSupported(IntegrationKernel::SSE))
+                        return IntegrationKernel::SSE;
+
+                return IntegrationKernel::SCALAR;
+        }
+
+
+        // Scalar kernel, it is also used for the entities left over by the vectorized kernels
+        void EntityIntegrator::integrateScalar(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                for(size_t i = 0; i < num; ++i)
+                {
+                        vel[i] += deltaTime * acc[i];
+                        pos[i] += deltaTime * vel[i];
+                        vel[i] *= ENTITY_DRAG_FACTOR;
+                        vel[i] = std::fabs(vel[i]) < ENTITY_MIN_VELOCITY ? 0.0f : vel[i];
+                        acc[i] = 0.0f;
+                }
+        }
+
+
+#ifdef ENTITY_INTEGRATOR_X86
+
+        // SSE kernel, updates 4 entities at a time
+        __attribute__((target("sse2")))
+        void EntityIntegrator::integrateSSE(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                const __m128 dt = _mm_set1_ps(deltaTime);
+                const __m128 drag = _mm_set1_ps(ENTITY_DRAG_FACTOR);
+                const __m128 minVel = _mm_set1_ps(ENTITY_MIN_VELOCITY);
+                const __m128 signMask = _mm_set1_ps(-0.0f);
+                const __m128 zero = _mm_setzero_ps();
+
+                size_t i = 0;
+                for(; i + 4 <= num; i += 4)
+                {
+                        __m128 v = _mm_add_ps(_mm_loadu_ps(vel + i), _mm_mul_ps(dt, _mm_loadu_ps(acc + i)));
+                        __m128 p = _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(dt, v));
+
+                        v = _mm_mul_ps(v, drag);
+                        v = _mm_andnot_ps(_mm_cmplt_ps(_mm_andnot_ps(signMask, v), minVel), v);
+
+                        _mm_storeu_ps(pos + i, p);
+                        _mm_storeu_ps(vel + i, v);
+                        _mm_storeu_ps(acc + i, zero);
+                }
+
+                integrateScalar(pos + i, vel + i, acc + i, num - i, deltaTime);
+        }
+
+
+        // AVX kernel, updates 8 entities at a time
+        __attribute__((target("avx")))
+        void EntityIntegrator::integrateAVX(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                const __m256 dt = _mm256_set1_ps(deltaTime);
+                const __m256 drag = _mm256_set1_ps(ENTITY_DRAG_FACTOR);
+                const __m256 minVel = _mm256_set1_ps(ENTITY_MIN_VELOCITY);
+                const __m256 signMask = _mm256_set1_ps(-0.0f);
+                const __m256 zero = _mm256_setzero_ps();
+
+                size_t i = 0;
+                for(; i + 8 <= num; i += 8)
+                {
+                        __m256 v = _mm256_add_ps(_mm256_loadu_ps(vel + i), _mm256_mul_ps(dt, _mm256_loadu_ps(acc + i)));
+                        __m256 p = _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(dt, v));
+
+                        v = _mm256_mul_ps(v, drag);
+                        v = _mm256_andnot_ps(_mm256_cmp_ps(_mm256_andnot_ps(signMask, v), minVel, _CMP_LT_OQ), v);
+
+                        _mm256_storeu_ps(pos + i, p);
+                        _mm256_storeu_ps(vel + i, v);
+                        _mm256_storeu_ps(acc + i, zero);
+                }
+
+                integrateScalar(pos + i, vel + i, acc + i, num - i, deltaTime);
+        }
+
+#else
+
+        // Vectorized kernels are not available on this platform (they are never selected since they are not supported)
+        void EntityIntegrator::integrateSSE(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                integrateScalar(pos, vel, acc, num, deltaTime);
+        }
+
+
+        void EntityIntegrator::integrateAVX(float* pos, float* vel, float* acc, size_t num, float deltaTime)
+        {
+                integrateScalar(pos, vel, acc, num, deltaTime);
+        }
+
+#endif
+
+}
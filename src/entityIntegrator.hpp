@@ -0,0 +1,54 @@
+
+// Contains definition of the EntityIntegrator class, this class integrates the motion of many entities at once.
+//
+// The integration works on the arrays of the entity store (one array for the positions on an axis, one for the velocities
+// and one for the accelerations) and is implemented by more kernels: a scalar one that works everywhere, an SSE one that
+// updates 4 entities at a time and an AVX one that updates 8 entities at a time.
+// The kernel is chosen at runtime (the first time it is needed) according to the features of the cpu, so the same
+// executable uses the fastest kernel available on the machine in which it runs. All the kernels compute exactly the same
+// values computed by Entity::update().
+//
+
+#ifndef ENTITY_INTEGRATOR_H
+#define ENTITY_INTEGRATOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+
+        enum class IntegrationKernel : uint32_t {
+                SCALAR,
+                SSE,
+                AVX
+        };
+
+
+        class EntityIntegrator {
+        public:
+                static void                     integrate(float* pos, float* vel, float* acc, size_t num, float deltaTime);
+
+                static bool                     isKernelSupported(IntegrationKernel kernel);
+                static bool                     setKernel(IntegrationKernel kernel);
+                static IntegrationKernel        getKernel();
+                static const char*              getKernelName(IntegrationKernel kernel);
+
+                static void                     integrateScalar(float* pos, float* vel, float* acc, size_t num, float deltaTime);
+                static void                     integrateSSE(float* pos, float* vel, float* acc, size_t num, float deltaTime);
+                static void                     integrateAVX(float* pos, float* vel, float* acc, size_t num, float deltaTime);
+
+        private:
+                using KernelFunction = void (*)(float*, float*, float*, size_t, float);
+
+                static IntegrationKernel        selectBestKernel();
+
+                static IntegrationKernel        s_kernel;       // Kernel used by integrate()
+                static KernelFunction           s_kernelFunc;   // Function that implements the kernel in use
+        };
+
+}
+
+#endif // ENTITY_INTEGRATOR_H
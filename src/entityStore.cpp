@@ -0,0 +1,126 @@
+
+
+#include "entityStore.hpp"
+#include "entityIntegrator.hpp"
+
+namespace mc2d {
+
+
+        // Adds a new entity to the store
+        // @e: the entity to add (its data is copied in the archetype of its type)
+        // @returns: the handle associated to the new entity, INVALID_ENTITY_HANDLE if the entity type is not valid
+        EntityHandle EntityStore::create(const Entity& e)
+        {
+                const size_t type = static_cast<size_t>(e.getType());
+                if(type >= ENTITY_TYPES_NUM)
+                {
+                        logError("EntityStore::create() failed, entity type %lu is not valid!", type);
+                        return INVALID_ENTITY_HANDLE;
+                }
+
+                uint32_t slot;
+                if(!m_freeSlots.empty())
+                {
+                        slot = m_freeSlots.back();
+                        m_freeSlots.pop_back();
+                } else {
+                        slot = (uint32_t) m_slots.size();
+                        m_slots.push_back( { 0, 0, e.getType() } );
+                }
+
+                EntityArchetype& a = m_archetypes[type];
+                m_slots[slot].index = (uint32_t) a.size();
+                m_slots[slot].type = e.getType();
+
+                a.posX.push_back(e.getPos().x);
+                a.posY.push_back(e.getPos().y);
+                a.prevPosX.push_back(e.getPos().x);
+                a.prevPosY.push_back(e.getPos().y);
+                a.velX.push_back(e.getVelocity().x);
+                a.velY.push_back(e.getVelocity().y);
+                a.accX.push_back(e.getAcceleration().x);
+                a.accY.push_back(e.getAcceleration().y);
+                a.health.push_back(e.getHealth());
+                a.facingRight.push_back(e.isFacingRight());
+                a.grounded.push_back(0);
+                a.slots.push_back(slot);
+
+                return { slot, m_slots[slot].generation };
+        }
+
+
+        // Removes an entity from the store, the last entity of the same archetype is moved in its place
+        // @h: handle of the entity to remove
+        // @returns: true if the entity has been removed, false if the handle was not valid
+        bool EntityStore::destroy(EntityHandle h)
+        {
+                if(!isValid(h))
+                        return false;
+
+                Location l = locate(h);
+                EntityArchetype& a = *l.a;
+                const size_t last = a.size() - 1;
+
+                a.posX[l.i] = a.posX[last];                     a.posX.pop_back();
+                a.posY[l.i] = a.posY[last];                     a.posY.pop_back();
+                a.prevPosX[l.i] = a.prevPosX[last];             a.prevPosX.pop_back();
+                a.prevPosY[l.i] = a.prevPosY[last];             a.prevPosY.pop_back();
+                a.velX[l.i] = a.velX[last];                     a.velX.pop_back();
+                a.velY[l.i] = a.velY[last];                     a.velY.pop_back();
+                a.accX[l.i] = a.accX[last];                     a.accX.pop_back();
+                a.accY[l.i] = a.accY[last];                     a.accY.pop_back();
+                a.health[l.i] = a.health[last];                 a.health.pop_back();
+                a.facingRight[l.i] = a.facingRight[last];       a.facingRight.pop_back();
+                a.grounded[l.i] = a.grounded[last];             a.grounded.pop_back();
+                a.slots[l.i] = a.slots[last];                   a.slots.pop_back();
+
+                if(l.i != last)
+                        m_slots[a.slots[l.i]].index = (uint32_t) l.i;
+
+                ++m_slots[h.index].generation;
+                m_freeSlots.push_back(h.index);
+                return true;
+        }
+
+
+        // Integrates the motion of all the entities in the store
+        // @deltaTime: time passed from the last update (measured in milliseconds)
+        void EntityStore::update(float deltaTime)
+        {
+                // Entity velocity and acceleration are expressed in seconds so we need to convert the delta time
+                const float deltaTimeInSec = deltaTime / 1000.0f;
+
+                for(EntityArchetype& a : m_archetypes)
+                {
+                        a.prevPosX.assign(a.posX.begin(), a.posX.end());
+                        a.prevPosY.assign(a.posY.begin(), a.posY.end());
+
+                        EntityIntegrator::integrate(a.posX.data(), a.velX.data(), a.accX.data(), a.size(), deltaTimeInSec);
+                        EntityIntegrator::integrate(a.posY.data(), a.velY.data(), a.accY.data(), a.size(), deltaTimeInSec);
+                }
+        }
+
+
+        // Checks if the given handle refers to an entity that is still in the store
+        // @h: the handle to check
+        // @returns: true if the handle is valid, false otherwise
+        bool EntityStore::isValid(EntityHandle h) const
+        {
+                return h.index < m_slots.size() && m_slots[h.index].generation == h.generation;
+        }
+
+
+        // Returns a copy of the data of the given entity
+        // @h: handle of the entity (must be valid)
+        Entity EntityStore::getEntity(EntityHandle h) const
+        {
+                const Location l = locate(h);
+
+                Entity e(glm::vec3(l.a->posX[l.i], l.a->posY[l.i], 0.0f), l.a->health[l.i], m_slots[h.index].type);
+                e.setVelocity(glm::vec3(l.a->velX[l.i], l.a->velY[l.i], 0.0f));
+                e.setAcceleration(glm::vec3(l.a->accX[l.i], l.a->accY[l.i], 0.0f));
+                e.setIsFacingRight(l.a->facingRight[l.i] != 0);
+                return e;
+        }
+
+}
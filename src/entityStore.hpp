@@ -0,0 +1,114 @@
+
+// Contains definition of the EntityStore class, this class keeps the data of all the entities in the game world (players
+// and mobs) in a structure of arrays layout.
+//
+// Entities of the same type are stored together in one archetype, an archetype keeps each property of its entities in a
+// separate contiguous array (all the x positions, then all the y positions, ...) so that the integration of the motion
+// can be executed over contiguous float arrays (see EntityIntegrator).
+// Entities are referred to with handles: a handle stays valid until its entity is destroyed, even when the entity gets
+// moved inside the arrays of its archetype (entities are removed by moving the last one in the hole left by the removed one).
+// The Entity class is still used to create entities and to save/load them.
+//
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+#include "log.hpp"
+#include "entity.hpp"
+
+namespace mc2d {
+
+
+        // Identifies one entity in the entity store, the generation is used to detect handles of entities that have been destroyed
+        struct EntityHandle {
+                uint32_t                index;                  // Index of the slot associated to the entity
+                uint32_t                generation;             // Generation of the slot when the entity has been created
+
+                inline bool             operator == (const EntityHandle& other) const   { return index == other.index && generation == other.generation; }
+                inline bool             operator != (const EntityHandle& other) const   { return !(*this == other); }
+        };
+
+        constexpr EntityHandle INVALID_ENTITY_HANDLE = { UINT32_MAX, UINT32_MAX };
+
+
+        // Keeps the data of all the entities of one type (each property is stored in its own array)
+        struct EntityArchetype {
+                std::vector<float>      posX;                   // Position of the entities in world coordinates
+                std::vector<float>      posY;
+                std::vector<float>      prevPosX;               // Position of the entities before the last update (used to interpolate the rendering)
+                std::vector<float>      prevPosY;
+                std::vector<float>      velX;                   // Velocity of the entities (measured in blocks/second)
+                std::vector<float>      velY;
+                std::vector<float>      accX;                   // Acceleration of the entities (measured in blocks/second^2)
+                std::vector<float>      accY;
+                std::vector<float>      health;
+                std::vector<uint8_t>    facingRight;
+                std::vector<uint8_t>    grounded;               // Non zero for the entities that are standing on a block (updated by the collision detection)
+                std::vector<uint32_t>   slots;                  // Slot associated to each entity (used to fix the slot when an entity is moved)
+
+                inline size_t           size() const            { return slots.size(); }
+        };
+
+
+        class EntityStore {
+        public:
+                EntityStore() = default;
+                ~EntityStore() = default;
+
+                EntityHandle            create(const Entity& e);
+                bool                    destroy(EntityHandle h);
+                void                    update(float deltaTime);
+
+                bool                    isValid(EntityHandle h) const;
+                Entity                  getEntity(EntityHandle h) const;
+                inline size_t           getEntitiesNum() const                  { return m_slots.size() - m_freeSlots.size(); }
+                inline EntityArchetype& getArchetype(EntityType type)           { return m_archetypes[static_cast<size_t>(type)]; }
+                inline const EntityArchetype& getArchetype(EntityType type) const { return m_archetypes[static_cast<size_t>(type)]; }
+                inline EntityHandle     getHandle(EntityType type, size_t index) const  { const uint32_t slot = m_archetypes[static_cast<size_t>(type)].slots[index]; return { slot, m_slots[slot].generation }; }
+
+                // The following methods must be called only with valid handles
+                inline glm::vec3        getPos(EntityHandle h) const                            { const Location l = locate(h); return glm::vec3(l.a->posX[l.i], l.a->posY[l.i], 0.0f); }
+                inline glm::vec3        getPrevPos(EntityHandle h) const                        { const Location l = locate(h); return glm::vec3(l.a->prevPosX[l.i], l.a->prevPosY[l.i], 0.0f); }
+                inline glm::vec3        getVelocity(EntityHandle h) const                       { const Location l = locate(h); return glm::vec3(l.a->velX[l.i], l.a->velY[l.i], 0.0f); }
+                inline float            getHealth(EntityHandle h) const                         { const Location l = locate(h); return l.a->health[l.i]; }
+                inline EntityType       getType(EntityHandle h) const                           { return m_slots[h.index].type; }
+                inline size_t           getIndex(EntityHandle h) const                          { return m_slots[h.index].index; }      // Index of the entity in its archetype
+                inline bool             isFacingRight(EntityHandle h) const                     { const Location l = locate(h); return l.a->facingRight[l.i] != 0; }
+                inline bool             isGrounded(EntityHandle h) const                        { const Location l = locate(h); return l.a->grounded[l.i] != 0; }
+
+                inline void             setPos(EntityHandle h, const glm::vec3& pos)            { const Location l = locate(h); l.a->posX[l.i] = l.a->prevPosX[l.i] = pos.x; l.a->posY[l.i] = l.a->prevPosY[l.i] = pos.y; }
+                inline void             setVelocity(EntityHandle h, const glm::vec3& vel)       { const Location l = locate(h); l.a->velX[l.i] = vel.x; l.a->velY[l.i] = vel.y; }
+                inline void             setAcceleration(EntityHandle h, const glm::vec3& acc)   { const Location l = locate(h); l.a->accX[l.i] = acc.x; l.a->accY[l.i] = acc.y; }
+                inline void             setHealth(EntityHandle h, float health)                 { const Location l = locate(h); l.a->health[l.i] = health; }
+                inline void             setIsFacingRight(EntityHandle h, bool value)            { const Location l = locate(h); l.a->facingRight[l.i] = value; }
+
+        private:
+
+                // Associates a handle to the position of its entity in the archetypes
+                struct EntitySlot {
+                        uint32_t        generation;             // Incremented each time the slot is released
+                        uint32_t        index;                  // Index of the entity in the arrays of its archetype
+                        EntityType      type;                   // Type of the entity (selects the archetype)
+                };
+
+                // Position of an entity in the archetypes
+                struct Location {
+                        EntityArchetype* a;
+                        size_t          i;
+                };
+
+                inline Location         locate(EntityHandle h)                  { return { &m_archetypes[static_cast<size_t>(m_slots[h.index].type)], m_slots[h.index].index }; }
+                inline Location         locate(EntityHandle h) const            { return const_cast<EntityStore*>(this)->locate(h); }
+
+                EntityArchetype         m_archetypes[ENTITY_TYPES_NUM]; // Data of the entities grouped by type (one archetype for each entity type)
+                std::vector<EntitySlot> m_slots;                        // One slot for each handle that has been given out
+                std::vector<uint32_t>   m_freeSlots;                    // Slots that can be reused by new entities
+        };
+
+}
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,76 @@
+
+#include "frameArena.hpp"
+
+namespace mc2d {
+
+
+        FrameArena::FrameArena(size_t capacity) : m_buffer(new uint8_t[capacity]), m_capacity(capacity), m_usedBytes(0),
+                m_lastAllocation(0), m_overflowBytes(0), m_overflows(0)
+        {}
+
+
+        // Takes a block of memory from the arena (or from the heap if the arena is full)
+        // @bytes: size of the block
+        // @alignment: alignment required for the block (must be a power of two)
+        // @returns: pointer to the block
+        void* FrameArena::allocate(size_t bytes, size_t alignment)
+        {
+                const uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer.get());
+                const size_t offset = ((base + m_usedBytes + alignment - 1) & ~(uintptr_t) (alignment - 1)) - base;
+
+                if(offset + bytes > m_capacity)
+                {
+                        m_overflowBytes += bytes + alignment;
+                        ++m_overflows;
+                        return ::operator new(bytes, std::align_val_t(alignment));
+                }
+
+                m_lastAllocation = offset;
+                m_usedBytes = offset + bytes;
+                return m_buffer.get() + offset;
+        }
+
+
+        // Gives back a block of memory, blocks of the arena are freed only by reset() (unless the block is the last one
+        // allocated, so a vector that grows does not waste its old storage)
+        // @ptr: the block
+        // @alignment: alignment that was required for the block
+        void FrameArena::deallocate(void* ptr, size_t alignment)
+        {
+                uint8_t* p = static_cast<uint8_t*>(ptr);
+                if(p < m_buffer.get() || p >= m_buffer.get() + m_capacity)
+                {
+                        ::operator delete(ptr, std::align_val_t(alignment));
+                        return;
+                }
+
+                if(p == m_buffer.get() + m_lastAllocation)
+                        m_usedBytes = m_lastAllocation;
+        }
+
+
+        // Frees all the memory allocated from the arena, if the last frame did not fit in the arena then the arena grows
+        // (nothing allocated from the arena must be alive when this is called)
+        void FrameArena::reset()
+        {
+                if(m_overflowBytes != 0)
+                {
+                        m_capacity = std::max(m_capacity * 2, m_usedBytes + m_overflowBytes);
+                        m_buffer.reset(new uint8_t[m_capacity]);
+                        logInfo("Frame arena grown to %lu bytes", m_capacity);
+                }
+
+                m_usedBytes = 0;
+                m_lastAllocation = 0;
+                m_overflowBytes = 0;
+        }
+
+
+        // Returns the arena of the calling thread (created the first time that it is needed)
+        FrameArena& FrameArena::getThreadArena()
+        {
+                static thread_local FrameArena arena;
+                return arena;
+        }
+
+}
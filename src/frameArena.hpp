@@ -0,0 +1,94 @@
+
+// Contains definition of the FrameArena class and of the FrameAllocator allocator, they are used for the temporary data
+// that lives only for one frame (lists of visible chunks, scratch arrays, ...).
+//
+// An arena is a buffer from which memory is taken by moving a pointer forward, nothing is freed until the arena is reset
+// (once per frame, at the beginning of Game::run() loop). If a frame needs more memory than the arena has the missing
+// memory is taken from the heap and the arena grows at the next reset, after a few frames the arena is big enough and
+// temporary data does not touch the heap anymore.
+// Each thread has its own arena (see getThreadArena()), FrameVector is a std::vector that takes its memory from the arena
+// of the thread that creates it. Data allocated from an arena must never outlive the frame in which it has been allocated.
+//
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+
+        constexpr size_t DEFAULT_FRAME_ARENA_CAPACITY = 64 * 1024;      // Initial size of the arenas (in bytes)
+
+
+        class FrameArena {
+        public:
+                FrameArena(size_t capacity = DEFAULT_FRAME_ARENA_CAPACITY);
+                ~FrameArena() = default;
+
+                // Delete copy constructors
+                FrameArena(const FrameArena& other) = delete;
+                FrameArena&             operator = (const FrameArena& other) = delete;
+
+                void*                   allocate(size_t bytes, size_t alignment);
+                void                    deallocate(void* ptr, size_t alignment);
+                void                    reset();
+
+                inline size_t           getCapacity() const                     { return m_capacity; }
+                inline size_t           getUsedBytes() const                    { return m_usedBytes; }
+                inline uint64_t         getOverflowsNum() const                 { return m_overflows; }
+
+                static FrameArena&      getThreadArena();
+
+        private:
+
+                std::unique_ptr<uint8_t[]> m_buffer;
+                size_t                  m_capacity;             // Size of the buffer (in bytes)
+                size_t                  m_usedBytes;            // Bytes of the buffer allocated since the last reset
+                size_t                  m_lastAllocation;       // Offset of the last allocation (it can be freed by moving back the used bytes)
+                size_t                  m_overflowBytes;        // Bytes taken from the heap since the last reset (because the buffer was full)
+                uint64_t                m_overflows;            // Number of allocations that did not fit in the buffer
+        };
+
+
+        // Allocator that takes memory from the arena of the thread that has created it (can be used with the std containers)
+        template <typename T>
+        class FrameAllocator {
+        public:
+                using value_type = T;
+
+                FrameAllocator() : m_arena(&FrameArena::getThreadArena())
+                {}
+
+                template <typename U>
+                FrameAllocator(const FrameAllocator<U>& other) : m_arena(other.getArena())
+                {}
+
+                inline T*               allocate(size_t n)                      { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+                inline void             deallocate(T* ptr, size_t)              { m_arena->deallocate(ptr, alignof(T)); }
+
+                inline FrameArena*      getArena() const                        { return m_arena; }
+
+                template <typename U>
+                inline bool             operator == (const FrameAllocator<U>& other) const      { return m_arena == other.getArena(); }
+
+                template <typename U>
+                inline bool             operator != (const FrameAllocator<U>& other) const      { return m_arena != other.getArena(); }
+
+        private:
+                FrameArena*             m_arena;
+        };
+
+
+        template <typename T>
+        using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}
+
+#endif // FRAME_ARENA_H
@@ -4,7 +4,8 @@
 namespace mc2d {
 
 
-        Game::Game() : m_gameState(GameState::UNINITIALIZED), m_window(NULL), m_currScene(nullptr)
+        Game::Game() : m_gameState(GameState::UNINITIALIZED), m_window(NULL), m_currScene(nullptr),
+                m_accumulator(0.0f), m_lastFrameAllocations(0), m_stopRendering(false), m_isViewportResized(false), m_framebufferWidth(0), m_framebufferHeight(0)
         {}
 
 
@@ -117,7 +118,8 @@ namespace mc2d {
         }
 
 
-        // Starts the main game loop
+        // Starts the main game loop, the scene is updated with fixed steps (SIMULATION_STEP_DURATION milliseconds each) so that
+        // the simulation does not depend on the frame rate, while the frames are drawn by the render thread
         void Game::run()
         {
                 if(m_gameState != GameState::INITIALIZED)
@@ -126,34 +128,104 @@ namespace mc2d {
                         return;
                 }
 
+                m_gameState = GameState::RUNNING;
+
+                // The OpenGL context is moved to the render thread
+                glfwMakeContextCurrent(NULL);
+                m_stopRendering = false;
+                m_renderThread = std::thread(&Game::renderLoop, this);
+
                 std::chrono::high_resolution_clock::time_point lastFrameTime = std::chrono::high_resolution_clock::now();
                 std::chrono::high_resolution_clock::time_point currFrameTime;
                 std::chrono::duration<float, std::milli> deltaTime;
 
                 while(!glfwWindowShouldClose(m_window))
                 {
+                        // Temporary data of the last frame is not used anymore
+                        FrameArena::getThreadArena().reset();
+                        const uint64_t frameStartAllocations = AllocationCounter::getCount();
+
                         // Compute delta time
                         currFrameTime = std::chrono::high_resolution_clock::now();
                         deltaTime = currFrameTime - lastFrameTime;
                         lastFrameTime = currFrameTime;
 
-                        m_renderer.clearScreen();
-
-                        if(m_currScene != nullptr)
+                        // The whole frame (simulation steps and snapshot) must not allocate once the scene is in a steady state,
+                        // the scene tells if it is after it has described the frame (the events are handled outside of the check)
                         {
-                                m_currScene->update(*this, deltaTime.count());
-                                m_currScene->render(*this, m_renderer);
+                                ZeroAllocationScope noAllocations("Game::run() frame");
+
+                                // Execute the simulation steps that fit in the time passed
+                                uint32_t stepsNum = 0;
+                                m_accumulator += deltaTime.count();
+                                for(; stepsNum < MAX_SIMULATION_STEPS_PER_FRAME && m_accumulator >= SIMULATION_STEP_DURATION; ++stepsNum)
+                                {
+                                        if(m_currScene != nullptr)
+                                                m_currScene->update(*this, SIMULATION_STEP_DURATION);
+
+                                        m_accumulator -= SIMULATION_STEP_DURATION;
+                                }
+
+                                if(m_accumulator >= SIMULATION_STEP_DURATION)           // Drop the steps that we cannot catch up with
+                                        m_accumulator = std::fmod(m_accumulator, SIMULATION_STEP_DURATION);
+
+                                // Describe the new state of the scene to the render thread
+                                if(stepsNum != 0 && m_currScene != nullptr)
+                                {
+                                        RenderSnapshot& snapshot = m_snapshots.getWriteBuffer();
+                                        m_currScene->render(*this, snapshot);
+
+                                        // The time left in the accumulator has already passed since the end of the last step
+                                        snapshot.time = currFrameTime - std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+                                                std::chrono::duration<float, std::milli>(m_accumulator));
+                                        m_snapshots.publish();
+                                }
+
+                                noAllocations.setEnabled(stepsNum != 0 && m_currScene != nullptr && m_currScene->isSteady());
                         }
 
-                        // Poll events and swap buffers
-                        glfwPollEvents();
-                        glfwSwapBuffers(m_window);
+                        m_lastFrameAllocations = AllocationCounter::getCount() - frameStartAllocations;
+
+                        // Handle the events received until the next step has to be simulated
+                        glfwWaitEventsTimeout((SIMULATION_STEP_DURATION - m_accumulator) / 1000.0f);
                 }
 
+                m_stopRendering = true;
+                m_renderThread.join();
+                glfwMakeContextCurrent(m_window);                       // Give back the context so that the resources can be released
+
                 m_gameState = GameState::QUITTED;
         }
 
 
+        // Main loop of the render thread, draws the most recent snapshot published by the main thread until the game is quitted
+        void Game::renderLoop()
+        {
+                glfwMakeContextCurrent(m_window);
+                glfwSwapInterval(1);                                    // Wait for the vertical sync instead of drawing frames that will never be shown
+
+                while(!m_stopRendering)
+                {
+                        if(m_isViewportResized.exchange(false))
+                                m_renderer.resizeViewport(m_framebufferWidth, m_framebufferHeight);
+
+                        // If no new snapshot has been published then the previous one is drawn again (further interpolated)
+                        m_snapshots.acquire();
+                        const RenderSnapshot& snapshot = m_snapshots.getReadBuffer();
+
+                        std::chrono::duration<float, std::milli> sinceSnapshot = std::chrono::high_resolution_clock::now() - snapshot.time;
+                        float interpolationFactor = std::clamp(sinceSnapshot.count() / SIMULATION_STEP_DURATION, 0.0f, 1.0f);
+
+                        m_renderer.clearScreen();
+                        m_renderer.renderSnapshot(snapshot, interpolationFactor);
+
+                        glfwSwapBuffers(m_window);
+                }
+
+                glfwMakeContextCurrent(NULL);
+        }
+
+
         // Sets the current scene of the game, it can be used to switch from a scene A to 
         // a scene B but after this call sceneA will be terminated so you must return control
         // immediately to the game class
@@ -189,8 +261,15 @@ namespace mc2d {
                 game->m_settings.windowWidth = (uint32_t) width;
                 game->m_settings.windowHeight = (uint32_t) height;
 
-                // Update render viewport
-                game->m_renderer.resizeViewport(newWidth, newHeight);
+                // Update render viewport (the OpenGL context belongs to the render thread while the game is running)
+                if(game->m_gameState == GameState::RUNNING)
+                {
+                        game->m_framebufferWidth = newWidth;
+                        game->m_framebufferHeight = newHeight;
+                        game->m_isViewportResized = true;
+                } else {
+                        game->m_renderer.resizeViewport(newWidth, newHeight);
+                }
         }
 
 
@@ -1,5 +1,11 @@
 
 // Contains definition of the Game class and the GameSettings struct.
+//
+// The game runs on two threads: the main thread handles the window events and simulates the current scene with fixed
+// steps, after the steps of each frame the scene describes what must be drawn in a RenderSnapshot. The render thread
+// owns the OpenGL context and draws the most recent snapshot (interpolating it with the time passed since it has been
+// taken), so simulation and rendering of consecutive frames overlap. Snapshots are passed with a triple buffer so the
+// two threads never wait for each other.
 
 #ifndef GAME_H
 #define GAME_H
@@ -7,13 +13,21 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 #include <filesystem>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/vec2.hpp>
 
 #include "log.hpp"
+#include "tripleBuffer.hpp"
+#include "frameArena.hpp"
+#include "allocationCounter.hpp"
 #include "graphics/renderer.hpp"
+#include "graphics/renderSnapshot.hpp"
 #include "graphics/camera.hpp"
 
 #include "scene/scene.hpp"
@@ -23,6 +37,10 @@
 namespace mc2d {
 
 
+        // Maximum number of simulation steps executed in one frame, if the game falls behind more than this then the simulation slows down
+        constexpr uint32_t MAX_SIMULATION_STEPS_PER_FRAME = 15;
+
+
         struct GameSettings {
                 uint32_t                windowWidth     = 720;                  // The width of the game window
                 uint32_t                windowHeight    = 480;                  // the height of the game window
@@ -44,6 +62,9 @@ namespace mc2d {
 
                 inline GameSettings&            getSettings()                   { return m_settings; }
 
+                // Returns the number of heap allocations made by the main thread in the last frame (always zero if AllocationCounter is not enabled)
+                inline uint64_t                 getLastFrameAllocations() const { return m_lastFrameAllocations; }
+
         private:
 
                 enum class GameState {
@@ -55,6 +76,8 @@ namespace mc2d {
                 };
 
 
+                void            renderLoop();
+
                 static void     onWindowResize(GLFWwindow* wnd, int width, int height);
                 static void     onKeyEvent(GLFWwindow* wnd, int key, int scancode, int action, int mods);
                 static void     onMouseButtonEvent(GLFWwindow* wnd, int btn, int action, int mods);
@@ -62,9 +85,19 @@ namespace mc2d {
                 GameState               m_gameState;                    // The current state of the game
                 GameSettings            m_settings;                     // The game settings
                 GLFWwindow*             m_window;                       // Game's main window
-                Renderer                m_renderer;
+                Renderer                m_renderer;                     // Used only by the render thread while the game is running
 
                 std::unique_ptr<Scene>  m_currScene;                    // The scene currently active 
+
+                float                   m_accumulator;                  // Time (in milliseconds) that still needs to be simulated
+                uint64_t                m_lastFrameAllocations;         // Heap allocations made by the main thread in the last frame (simulation and snapshot)
+
+                TripleBuffer<RenderSnapshot> m_snapshots;               // Frames described by the scene and drawn by the render thread
+                std::thread             m_renderThread;
+                std::atomic<bool>       m_stopRendering;                // Set by the main thread to stop the render thread
+                std::atomic<bool>       m_isViewportResized;            // Set when the size of the framebuffer changes (the viewport is resized by the render thread)
+                std::atomic<int>        m_framebufferWidth;
+                std::atomic<int>        m_framebufferHeight;
         };
 
 }
@@ -73,9 +73,13 @@ namespace mc2d {
         // @point: point on which camera will be centered
         void Camera::centerOnPoint(const glm::vec3& point)
         {
-                m_pos.x = point.x - ((float) m_width / 2.0f);
-                m_pos.y = point.y + ((float) m_height / 2.0f);
-                m_hasChanged = true;
+                glm::vec3 newPos(point.x - ((float) m_width / 2.0f), point.y + ((float) m_height / 2.0f), m_pos.z);
+
+                if(newPos != m_pos)                     // The visible blocks change only if the camera moves
+                {
+                        m_pos = newPos;
+                        m_hasChanged = true;
+                }
         }
 
 }
@@ -0,0 +1,80 @@
+
+// Contains definition of the RenderSnapshot struct, a snapshot contains everything that is needed to draw one frame.
+//
+// Snapshots are filled by the current scene on the simulation thread (after the simulation steps of a frame) and passed
+// to the render thread (that owns the OpenGL context) with a triple buffer, so the render thread never reads the game
+// world while the simulation modifies it. The vertices of the visible blocks are built on the simulation thread and
+// shared between snapshots (they are rebuilt only when the world or the camera change), the render thread uploads them
+// to the gpu only when it receives a new mesh.
+// Entities and camera are stored with their position before and after the last simulation step so that the render
+// thread can interpolate them at any frame rate.
+//
+
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+#include "camera.hpp"
+
+namespace mc2d {
+
+
+        // This struct defines the memory layout of one vertex that makes up a block,
+        // each block is made up of 6 of those (2 triangles with 3 vertices each)
+        struct BlockVertex {
+                float   position[2];
+                float   uv[2];
+                float   tileId;
+                float   light[2];       // Sky light and block light levels (normalized in range [0, 1])
+        };
+
+
+        // Vertices of the blocks visible from a camera, a mesh is never modified after it has been built
+        struct WorldMesh {
+                uint64_t                        id;                     // Unique id of the mesh (used by the render thread to detect new meshes)
+                std::vector<BlockVertex>        vertices;
+        };
+
+
+        // Sprites that can be drawn by the render thread (loaded by the renderer)
+        enum class SpriteId : uint8_t {
+                PLAYER_HEAD,
+
+                SPRITES_NUM
+        };
+
+
+        // One sprite to draw in a frame
+        struct SpriteInstance {
+                SpriteId                        sprite;
+                glm::vec3                       prevPos;                // Position of the sprite before the last simulation step
+                glm::vec3                       pos;                    // Position of the sprite after the last simulation step
+                glm::vec3                       scale;
+        };
+
+
+        struct RenderSnapshot {
+                std::shared_ptr<const WorldMesh> worldMesh;             // Blocks to draw (nullptr if the scene does not draw a world)
+                float                           skyLightFactor = 1.0f;
+                bool                            wireframe = false;      // Draw only the edges of the triangles (debug)
+
+                Camera                          camera = Camera(0.0f, 0.0f, 1.0f, 18, 18);
+                glm::vec3                       prevCameraPos;          // Position of the camera before the last simulation step
+
+                std::vector<SpriteInstance>     sprites;
+
+                // Time at which the last simulation step ended, the render thread interpolates with the time passed since then
+                std::chrono::high_resolution_clock::time_point  time;
+
+                // Empties the snapshot (the frame will only be cleared)
+                inline void                     clear()                 { worldMesh = nullptr; wireframe = false; sprites.clear(); }
+        };
+
+}
+
+#endif // RENDER_SNAPSHOT_H
@@ -34,6 +34,21 @@ namespace mc2d {
                         return 1;
                 }
 
+                if(!loadSprites())
+                {
+                        logError("Render::init() failed, cannot load sprites!");
+                        terminateSpriteRenderingData();
+                        return 1;
+                }
+
+                if(m_worldRenderer.init(Chunk::width * Chunk::height) != 0)
+                {
+                        logError("Render::init() failed, initialization of WorldRenderer failed!");
+                        unloadSprites();
+                        terminateSpriteRenderingData();
+                        return 1;
+                }
+
                 m_isInit = true;
                 return 0;
         }
@@ -45,6 +60,8 @@ namespace mc2d {
                 if(!m_isInit)
                         return;
 
+                m_worldRenderer.terminate();
+                unloadSprites();
                 terminateSpriteRenderingData();
 
                 m_isInit = false;
@@ -73,6 +90,38 @@ namespace mc2d {
         }
 
 
+        // Renders the frame described by the given snapshot
+        // @snapshot: contains everything that must be drawn
+        // @interpolationFactor: fraction of a simulation step passed since the snapshot has been taken (in range [0, 1]),
+        // used to draw camera and sprites between their positions before and after the last simulation step
+        void Renderer::renderSnapshot(const RenderSnapshot& snapshot, float interpolationFactor)
+        {
+                if(!m_isInit)
+                {
+                        logWarn("Renderer::renderSnapshot() failed, renderer has not been initialized correctly!");
+                        return;
+                }
+
+                // The polygon mode is part of the OpenGL state, so it is set here on the render thread
+                glPolygonMode(GL_FRONT_AND_BACK, snapshot.wireframe ? GL_LINE : GL_FILL);
+
+                if(snapshot.worldMesh == nullptr)
+                        return;
+
+                Camera camera = snapshot.camera;
+                glm::vec3 cameraPos = snapshot.prevCameraPos + (snapshot.camera.getPos() - snapshot.prevCameraPos) * interpolationFactor;
+                camera.setPos(cameraPos);
+
+                m_worldRenderer.render(*snapshot.worldMesh, camera, snapshot.skyLightFactor);
+
+                for(const SpriteInstance& s : snapshot.sprites)
+                {
+                        glm::vec3 pos = s.prevPos + (s.pos - s.prevPos) * interpolationFactor;
+                        renderSprite(m_sprites[static_cast<size_t>(s.sprite)], pos, s.scale, 0.0f, camera);
+                }
+        }
+
+
         // Renders the given sprite
         // @sprite: the 2D image to be rendered
         // @pos: defines the position (in world space coordinates) of the top left corner of the sprite
@@ -157,6 +206,45 @@ namespace mc2d {
         }
 
 
+        // Loads the images of all the sprites that can be referenced by the snapshots
+        // @returns: true on success, false otherwise
+        bool Renderer::loadSprites()
+        {
+                // Path of the image of each sprite (in the order of SpriteId)
+                static const char* spritesPaths[] = {
+                        "../resources/textures/player/steveHead.png"
+                };
+
+                static_assert(sizeof(spritesPaths) / sizeof(spritesPaths[0]) == static_cast<size_t>(SpriteId::SPRITES_NUM));
+
+                for(size_t i = 0; i < static_cast<size_t>(SpriteId::SPRITES_NUM); ++i)
+                {
+                        if(!m_sprites[i].load(spritesPaths[i]))
+                        {
+                                logError("Renderer::loadSprites() failed, cannot load sprite \"%s\"!", spritesPaths[i]);
+                                unloadSprites();
+                                return false;
+                        }
+                }
+
+                return true;
+        }
+
+
+        // Unloads the sprites loaded by loadSprites()
+        void Renderer::unloadSprites()
+        {
+                for(Sprite& s : m_sprites)
+                {
+                        if(s.isInit())
+                        {
+                                s.deactivate();
+                                s.unload();
+                        }
+                }
+        }
+
+
         // Terminates all the resources needed to render sprites
         void Renderer::terminateSpriteRenderingData()
         {
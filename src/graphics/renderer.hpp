@@ -1,5 +1,6 @@
 
 // Contans definition of the renderer class, this class is responsible for drawing blocks and game objects
+// (all the frames are drawn from a RenderSnapshot by the render thread)
 
 #ifndef RENDERER_H
 #define RENDERER_H
@@ -11,6 +12,8 @@
 #include "shader.hpp"
 #include "sprite.hpp"
 #include "camera.hpp"
+#include "worldRenderer.hpp"
+#include "renderSnapshot.hpp"
 
 namespace mc2d {
 
@@ -35,6 +38,8 @@ namespace mc2d {
                 void            resizeViewport(int newWidth, int newHeight);
                 void            clearScreen();
 
+                void            renderSnapshot(const RenderSnapshot& snapshot, float interpolationFactor);
+
                 void            renderSprite(const Sprite& sprite, const glm::vec3& pos, const glm::vec3& scale, const float rotation, const Camera& camera);
                 void            renderSprite(const Sprite& sprite, const glm::mat4& modelMat, const glm::mat4& viewMat, const glm::mat4& projectionMat);
 
@@ -42,6 +47,8 @@ namespace mc2d {
 
                 int             initSpriteRenderingData();
                 void            terminateSpriteRenderingData();
+                bool            loadSprites();
+                void            unloadSprites();
 
                 bool            m_isInit;
 
@@ -49,6 +56,9 @@ namespace mc2d {
                 uint32_t        m_spriteVao;
                 uint32_t        m_spriteVbo;
                 Shader          m_spriteShader;
+                Sprite          m_sprites[static_cast<size_t>(SpriteId::SPRITES_NUM)];  // Sprites that can be referenced by the snapshots
+
+                WorldRenderer   m_worldRenderer;
         };
 }
 
@@ -113,6 +113,27 @@ namespace mc2d {
         }
 
 
+        // Set value for the given uniform
+        // @uniform: id of the uniform to be setted
+        // @value: value used to set the uniform
+        void Shader::setUniform(int uniformId, float value) const
+        {
+                if(!isInit())
+                {
+                        logWarn("Shader::setUniform() failed, shader has not been initialized!");
+                        return;
+                }
+
+                if(uniformId == -1)
+                {
+                        logWarn("Shader::setUniform() failed, given uniform id is invalid!");
+                        return;
+                }
+
+                glUniform1f(uniformId, value);
+        }
+
+
         // Loads the content of the file with given filename and stores it into a string
         // @filename: name of the file from which code must be loaded
         // @returns: a string that contains the source file content
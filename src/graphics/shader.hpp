@@ -36,6 +36,7 @@ namespace mc2d {
 
                 int             getUniformId(const std::string& uniformName) const;
                 void            setUniform(int uniformId, const glm::mat4x4& value) const;
+                void            setUniform(int uniformId, float value) const;
 
         private:
 
@@ -0,0 +1,406 @@
+
+#include "worldMesher.hpp"
+
+namespace mc2d {
+
+
+        uint64_t WorldMesher::s_lastMeshId = 0;
+
+
+        // Builds the mesh of the blocks (and of the falling blocks) of the given world that are visible from the given camera
+        // @world: the world of which blocks will be considered
+        // @camera: the point from which the world is looked at
+        // @optimized: if true adjacent blocks of the same type are merged (see optimizedComputeVisibleBlocksVertices)
+        // @returns: the mesh built
+        std::shared_ptr<const WorldMesh> WorldMesher::buildMesh(GameWorld& world, const Camera& camera, bool optimized)
+        {
+                std::shared_ptr<WorldMesh> mesh = std::make_shared<WorldMesh>();
+                mesh->id = ++s_lastMeshId;
+
+                // The visible area is scanned one block beyond the camera size, the falling blocks are appended after it
+                size_t maxBlocksNum = ((size_t) camera.getWidth() + 1) * ((size_t) camera.getHeight() + 1);
+                for(const FallingColumn& column : world.getFallingColumns())
+                        maxBlocksNum += column.blocks.size();
+
+                mesh->vertices.resize(maxBlocksNum * 6);
+
+                size_t verticesNum = 0;
+                if(optimized)
+                        optimizedComputeVisibleBlocksVertices(world, camera, mesh->vertices.data(), mesh->vertices.size(), verticesNum);
+                else
+                        computeVisibleBlocksVertices(world, camera, mesh->vertices.data(), mesh->vertices.size(), verticesNum);
+
+                computeFallingBlocksVertices(world, camera, mesh->vertices.data(), mesh->vertices.size(), verticesNum);
+
+                mesh->vertices.resize(verticesNum);
+                return mesh;
+        }
+
+
+        // Computes the vertices (in world coordinates) and the texture coordinates for all the blocks in
+        // the given world that are visible from the given camera (and that are in an already loaded chunk)
+        // @world: the world of which blocks will be considered
+        // @camera: the point from which the world is looked at
+        // @vertices: memory buffer in which the computed vertices will be stored
+        // @maxVerticesNum: maximum amount of elements that can be stored in the given buffer
+        // @verticesNum: variable in which the number of vertices computed will be written
+        // @returns: number of blocks for which vertices have been computed (number of blocks visible)
+        size_t WorldMesher::computeVisibleBlocksVertices(GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum)
+        {
+                if(vertices == nullptr || maxVerticesNum == 0)
+                {
+                        logError("WorldMesher::computeVisibleBlocksVertices() failed, cannot store vertices "
+                                        "in the given buffer because such buffer is nullptr or its size is zero!");
+                        return 0;
+                }
+
+                verticesNum = 0;
+                size_t vertexIndex = 0;                                         // Counter for the elements inserted in the vertices buffer
+                size_t blocksNum = 0;                                           // Counter to keep track of the blocks for which vertices have been generated
+
+                // Step 1] Determine all the chunks that are covered by the camera (their snapshots are read)
+                FrameVector<std::shared_ptr<const ChunkSnapshot>> intersectedChunks = world.getVisibleChunkSnapshots(camera);
+                if(intersectedChunks.size() == 0)
+                        return 0;
+
+                glm::vec<2, size_t> initialIndex(0, 0);                         // X and Y indexes of the first block visible from the camera (relative to the blocks array of the first chunk)
+                glm::vec2 initialPos(0.0f, 0.0f);                               // X and y coordinates (in world space) of the top left vertex of the first block that is visible from the camera
+
+                // Step 2] Determine the indexes and the world position of the first block that is visible from the camera
+                if(camera.getPos().x <= intersectedChunks[0]->getPos().x)       // Camera origin is at the left of the chunk origin
+                {
+                        initialIndex.x = 0;
+                        initialPos.x = intersectedChunks[0]->getPos().x;
+                } else {
+                        initialIndex.x = std::floor(camera.getPos().x - intersectedChunks[0]->getPos().x);
+                        initialPos.x = intersectedChunks[0]->getPos().x + ( (float) initialIndex.x * BLOCK_WIDTH);
+                }
+
+                if(camera.getPos().y < intersectedChunks[0]->getPos().y)        // Camera origin is below the chunk origin
+                {
+                        initialIndex.y = std::floor(intersectedChunks[0]->getPos().y - camera.getPos().y);
+                        initialPos.y = intersectedChunks[0]->getPos().y - ( (float) initialIndex.y * BLOCK_HEIGHT);
+                } else {
+                        initialIndex.y = 0;
+                        initialPos.y = intersectedChunks[0]->getPos().y;
+                }
+
+                glm::vec<2, size_t> currIndex = initialIndex;                   // X and Y indexes of the current block (relative to the blocks array of the current chunk)
+                glm::vec2 currPos = initialPos;                                 // X and y coordinates (in world space) of the top left vertex of the current block
+                
+                // Step 3] Iterate over the region of space that is visible from the camera (+ 1 block of safety)
+                for(size_t i = 0; i <= camera.getHeight(); ++i, currPos.y -= BLOCK_HEIGHT)
+                {
+                        auto currChunk = intersectedChunks.begin();
+
+                        if(currPos.y > (*currChunk)->getPos().y)                // If we are on top of the chunk then there is no block to analyze so skip this line
+                                continue;
+                        else if(currPos.y <= 0)                                 // If we are below the chunk then there's no more blocks to render, our job is done
+                                break;
+
+                        // Reset values for the x axis
+                        currIndex.x = initialIndex.x;
+                        currPos.x = initialPos.x;
+
+                        for(size_t j = 0; j <= camera.getWidth(); ++j, currPos.x += BLOCK_WIDTH)
+                        {
+                                if(currIndex.x == Chunk::width)                 // Handle passage to the adjacent chunk
+                                {
+                                        ++currChunk;
+                                        if(currChunk == intersectedChunks.end())
+                                                break;
+
+                                        currIndex.x = 0;
+                                }
+
+                                // Step 4] generate vertices for all blocks that are not air
+                                size_t currBlockIndex = (currIndex.y * Chunk::width) + currIndex.x;
+                                BlockType currBlock = (*currChunk)->blocks[currBlockIndex];
+                                if(currBlock == BlockType::AIR)
+                                {
+                                        ++currIndex.x;
+                                        continue;
+                                }
+
+                                // Fluid blocks that are not full are drawn lower
+                                float topY = currPos.y - getFluidGap((*currChunk)->fluidLevels[currBlockIndex]);
+
+                                if(!generateBlockVertices(vertices, vertexIndex, maxVerticesNum, currPos.x, topY, currPos.x + BLOCK_WIDTH, currPos.y - BLOCK_HEIGHT, currBlock,
+                                                        (*currChunk)->skyLight[currBlockIndex], (*currChunk)->blockLight[currBlockIndex]))
+                                {
+                                        logError("WorldMesher::computeVisibleBlocksVertices() failed, cannot store all vertices in the given buffer,"
+                                                        "the number of vertices of the visible blocks is greater than the given buffer size");
+
+                                        verticesNum = vertexIndex;
+                                        return blocksNum;
+                                }
+
+                                ++blocksNum;
+                                ++currIndex.x;
+                        }
+                        ++currIndex.y;
+                }
+
+                verticesNum = vertexIndex;
+                return blocksNum;
+        }
+
+
+        // Computes the vertices (in world coordinates) and the texture coordinates for all the blocks in
+        // the given world that are visible from the given camera (and that are in an already loaded chunk), to do
+        // so it uses a 1D greedy meshing algorithm that composes adjacent block of the same type in one single rectangle.
+        // @world: the world of which blocks will be considered
+        // @camera: the point from which the world is looked at
+        // @vertices: memory buffer in which the computed vertices will be stored
+        // @maxVerticesNum: maximum amount of floats that can be stored in the given buffer
+        // @verticesNum: variable in which the number of vertices computed will be written
+        // @returns: number of blocks for which vertices have been computed (number of blocks visible)
+        size_t WorldMesher::optimizedComputeVisibleBlocksVertices(GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum)
+        {
+                if(vertices == nullptr || maxVerticesNum == 0)
+                {
+                        logError("WorldMesher::optimizedComputeVisibleBlocksVertices() failed, cannot store vertices "
+                                        "in the given buffer because such buffer is nullptr or its size is zero!");
+                        return 0;
+                }
+        
+                verticesNum = 0;
+                size_t vertexIndex = 0;                                         // Counter for the elements inserted in the vertices buffer
+                size_t blocksNum = 0;                                           // Counter to keep track of the blocks for which vertices have been generated
+
+                // Step 1] Determine all the chunks that are covered by the camera (their snapshots are read)
+                FrameVector<std::shared_ptr<const ChunkSnapshot>> intersectedChunks = world.getVisibleChunkSnapshots(camera);
+                if(intersectedChunks.size() == 0)
+                        return 0;
+
+                glm::vec<2, size_t> initialIndex(0, 0);                         // X and Y indexes of the first block visible from the camera (relative to the blocks array of the first chunk)
+                glm::vec2 initialPos(0.0f, 0.0f);                               // X and y coordinates (in world space) of the top left vertex of the first block that is visible from the camera
+
+                // Step 2] Determine the indexes and the world position of the first block that is visible from the camera
+                if(camera.getPos().x <= intersectedChunks[0]->getPos().x)         // Camera origin is at the left of the chunk origin
+                {
+                        initialIndex.x = 0;
+                        initialPos.x = intersectedChunks[0]->getPos().x;
+                } else {
+                        initialIndex.x = std::floor(camera.getPos().x - intersectedChunks[0]->getPos().x);
+                        initialPos.x = intersectedChunks[0]->getPos().x + ( (float) initialIndex.x * BLOCK_WIDTH);
+                }
+
+                if(camera.getPos().y < intersectedChunks[0]->getPos().y)          // Camera origin is below the chunk origin
+                {
+                        initialIndex.y = std::floor(intersectedChunks[0]->getPos().y - camera.getPos().y);
+                        initialPos.y = intersectedChunks[0]->getPos().y - ( (float) initialIndex.y * BLOCK_HEIGHT);
+                } else {
+                        initialIndex.y = 0;
+                        initialPos.y = intersectedChunks[0]->getPos().y;
+                }
+
+                glm::vec<2, size_t> currIndex = initialIndex;           // X and Y indexes of the current block (relative to the blocks array of the current chunk)
+                glm::vec2 currPos = initialPos;                         // X and y coordinates (in world space) of the top left vertex of the current block
+                
+                // Step 3] Iterate over the region of space that is visible from the camera (+ 1 block of safety)
+                for(size_t i = 0; i <= camera.getHeight(); ++i, currPos.y -= BLOCK_HEIGHT)
+                {
+                        auto currChunk = intersectedChunks.begin();
+
+                        if(currPos.y > (*currChunk)->getPos().y)        // If we are on top of the chunk then there is no block to analyze so skip this line
+                                continue;
+                        else if(currPos.y <= 0)                         // If we are below the chunk then there's no more blocks to render, our job is done
+                                break;
+
+                        // Reset values for the x axis
+                        currIndex.x = initialIndex.x;
+                        currPos.x = initialPos.x;
+
+                        for(size_t j = 0; j <= camera.getWidth(); ++j)
+                        {
+                                size_t k;
+                                float firstBlockPosX = currPos.x;
+                                size_t firstBlockIndex = (currIndex.y * Chunk::width) + currIndex.x;
+                                BlockType firstBlock = (*currChunk)->blocks[firstBlockIndex];
+                                uint8_t firstSkyLight = (*currChunk)->skyLight[firstBlockIndex];
+                                uint8_t firstBlockLight = (*currChunk)->blockLight[firstBlockIndex];
+                                uint8_t firstFluidLevel = (*currChunk)->fluidLevels[firstBlockIndex];
+                                size_t counter = 0;
+
+                                // Step 4] Use greedy meshing to compose adjacent blocks of the same type (and with the same light) into one single rectangle
+                                for(k = j; k <= camera.getWidth(); ++k, currPos.x += BLOCK_WIDTH, ++currIndex.x)
+                                {
+                                        if(currIndex.x == Chunk::width)         // Handle passage to the adjacent chunk
+                                        {
+                                                ++currChunk;
+                                                if(currChunk == intersectedChunks.end())
+                                                {
+                                                        k = SIZE_MAX - 1;       // This makes sure that we will exit the outer loop too
+                                                        break;
+                                                }
+
+                                                currIndex.x = 0;
+                                        }
+
+                                        size_t currBlockIndex = (currIndex.y * Chunk::width) + currIndex.x;
+                                        if((*currChunk)->blocks[currBlockIndex] != firstBlock)
+                                                break;
+
+                                        // Air is not rendered so its light does not matter
+                                        if(firstBlock != BlockType::AIR && ((*currChunk)->skyLight[currBlockIndex] != firstSkyLight ||
+                                                                (*currChunk)->blockLight[currBlockIndex] != firstBlockLight ||
+                                                                (*currChunk)->fluidLevels[currBlockIndex] != firstFluidLevel))
+                                                break;
+
+                                        ++counter;
+                                }
+
+                                // Step 5] Generate vertices for the rectangle resulting from the application of greedy meshing
+                                if(firstBlock != BlockType::AIR)
+                                {
+                                        if(!generateBlockVertices(vertices, vertexIndex, maxVerticesNum, firstBlockPosX, currPos.y - getFluidGap(firstFluidLevel),
+                                                                currPos.x, currPos.y - BLOCK_HEIGHT, firstBlock, firstSkyLight, firstBlockLight))
+                                        {
+                                                logError("WorldMesher::optimizedComputeVisibleBlocksVertices() failed, cannot store all vertices in the given buffer,"
+                                                                "the number of vertices of the visible blocks is greater than the given buffer size");
+
+                                                verticesNum = vertexIndex;
+                                                return blocksNum;
+                                        }
+
+                                        ++blocksNum;
+                                }
+
+                                j = k - 1;
+                        }
+
+                        ++currIndex.y;
+                }
+
+                verticesNum = vertexIndex;
+                return blocksNum;
+        }
+
+
+        // Utility function that generates vertices for blocks in a way such that the blocks generated will fill the given area
+        // @vertices: memory buffer in which the computed vertices will be stored
+        // @index: specifies the starting point in the buffer 
+        // @maxVerticesNum: maximum amount of floats that can be stored in the given buffer
+        // @startX, startY: x and y coordinates in world space of the top left corner of the area to be filled
+        // @endX, endY: x and y coordinates in world space of the bottom right corner of the area to be filled
+        // @blockType: the type of block to be used for fill the area
+        // @skyLight: sky light level of the blocks in the area
+        // @blockLight: block light level of the blocks in the area
+        bool WorldMesher::generateBlockVertices(BlockVertex* vertices, size_t& index, const size_t& maxVerticesNum,
+                        const float& startX, const float& startY, const float& endX, const float& endY, BlockType block,
+                        uint8_t skyLight, uint8_t blockLight)
+        {
+                if(vertices == nullptr || index + 6 > maxVerticesNum)
+                        return false;
+
+                float uCoord = endX - startX;
+                float vCoord = startY - endY;
+                float normalizedSkyLight = (float) skyLight / (float) MAX_LIGHT_LEVEL;
+                float normalizedBlockLight = (float) blockLight / (float) MAX_LIGHT_LEVEL;
+
+                // First triangle bottom left vertex
+                vertices[index + 0].position[0] = startX;               // x
+                vertices[index + 0].position[1] = endY;                 // y
+                vertices[index + 0].uv[0]       = 0.0f;                 // u
+                vertices[index + 0].uv[1]       = 0.0f;                 // v
+                vertices[index + 0].tileId      = (float) block;        // tile id
+
+                // First triangle bottom right vertex
+                vertices[index + 1].position[0] = endX;                 // x
+                vertices[index + 1].position[1] = endY;                 // y
+                vertices[index + 1].uv[0]       = uCoord;               // u
+                vertices[index + 1].uv[1]       = 0.0f;                 // v
+                vertices[index + 1].tileId      = (float) block;        // tile id
+
+                // First triangle top left vertex
+                vertices[index + 2].position[0] = startX;               // x
+                vertices[index + 2].position[1] = startY;               // y
+                vertices[index + 2].uv[0]       = 0.0f;                 // u
+                vertices[index + 2].uv[1]       = vCoord;               // v
+                vertices[index + 2].tileId      = (float) block;        // tile id
+                
+                // Second triangle bottom right vertex
+                vertices[index + 3].position[0] = endX;                 // x
+                vertices[index + 3].position[1] = endY;                 // y
+                vertices[index + 3].uv[0]       = uCoord;               // u
+                vertices[index + 3].uv[1]       = 0.0f;                 // v
+                vertices[index + 3].tileId      = (float) block;        // tile id
+                
+                // Second triangle top right vertex
+                vertices[index + 4].position[0] = endX;                 // x
+                vertices[index + 4].position[1] = startY;               // y
+                vertices[index + 4].uv[0]       = uCoord;               // u
+                vertices[index + 4].uv[1]       = vCoord;               // v
+                vertices[index + 4].tileId      = (float) block;        // tile id
+                
+                // Second triangle top left vertex
+                vertices[index + 5].position[0] = startX;               // x
+                vertices[index + 5].position[1] = startY;               // y
+                vertices[index + 5].uv[0]       = 0.0f;                 // u
+                vertices[index + 5].uv[1]       = vCoord;               // v
+                vertices[index + 5].tileId      = (float) block;        // tile id
+
+                for(size_t i = index; i < index + 6; ++i)
+                {
+                        vertices[i].light[0] = normalizedSkyLight;
+                        vertices[i].light[1] = normalizedBlockLight;
+                }
+
+                index += 6;
+                return true;
+        }
+
+
+        // Computes the vertices (in world coordinates) and the texture coordinates for all the falling blocks in the
+        // given world that are visible from the given camera, the vertices are appended to the ones already in the buffer
+        // @world: the world of which falling blocks will be considered
+        // @camera: the point from which the world is looked at
+        // @vertices: memory buffer in which the computed vertices will be stored
+        // @maxVerticesNum: maximum amount of elements that can be stored in the given buffer
+        // @verticesNum: number of vertices already stored in the buffer, it will be increased by the number of vertices computed
+        // @returns: number of blocks for which vertices have been computed
+        size_t WorldMesher::computeFallingBlocksVertices(const GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum)
+        {
+                size_t blocksNum = 0;
+
+                for(const FallingColumn& column : world.getFallingColumns())
+                {
+                        auto c = world.getLoadedChunks().find(Chunk::getIdFromBlockX(column.x));
+                        float posX = (float) column.x * BLOCK_WIDTH;
+
+                        for(size_t i = 0; i < column.blocks.size(); ++i)
+                        {
+                                float bottomY = column.bottomY + (float) i * BLOCK_HEIGHT;
+                                if(!doesRectsIntersect(camera.getPos().x, camera.getPos().y, (float) camera.getWidth(), (float) camera.getHeight(),
+                                                        posX, bottomY + BLOCK_HEIGHT, BLOCK_WIDTH, BLOCK_HEIGHT))
+                                        continue;
+
+                                // Falling blocks take the light of the position that contains their center
+                                uint8_t skyLight = MAX_LIGHT_LEVEL;
+                                uint8_t blockLight = 0;
+                                int centerY = (int) std::floor(bottomY + BLOCK_HEIGHT / 2.0f);
+
+                                if(c != world.getLoadedChunks().end() && centerY >= 0 && centerY < (int) Chunk::height)
+                                {
+                                        size_t index = c->second.getBlockIndex(column.x, centerY);
+                                        skyLight = c->second.skyLight[index];
+                                        blockLight = c->second.blockLight[index];
+                                }
+
+                                if(!generateBlockVertices(vertices, verticesNum, maxVerticesNum, posX, bottomY + BLOCK_HEIGHT, posX + BLOCK_WIDTH, bottomY,
+                                                        column.blocks[i], skyLight, blockLight))
+                                {
+                                        logError("WorldMesher::computeFallingBlocksVertices() failed, cannot store all vertices in the given buffer,"
+                                                        "the number of vertices of the visible blocks is greater than the given buffer size");
+                                        return blocksNum;
+                                }
+
+                                ++blocksNum;
+                        }
+                }
+
+                return blocksNum;
+        }
+
+}
@@ -0,0 +1,43 @@
+
+// Contains definition of the WorldMesher class, this class computes the vertices of the blocks of a world that are visible
+// from a camera. It does not use OpenGL so the meshes can be built on the simulation thread and then passed to the render
+// thread (see RenderSnapshot).
+//
+
+#ifndef WORLD_MESHER_H
+#define WORLD_MESHER_H
+
+#include <memory>
+#include <cstdint>
+
+#include "log.hpp"
+#include "world/gameWorld.hpp"
+#include "renderSnapshot.hpp"
+#include "camera.hpp"
+
+namespace mc2d {
+
+
+        class WorldMesher {
+        public:
+                static std::shared_ptr<const WorldMesh> buildMesh(GameWorld& world, const Camera& camera, bool optimized);
+
+        private:
+
+                static size_t   computeVisibleBlocksVertices(GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum);
+                static size_t   optimizedComputeVisibleBlocksVertices(GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum);
+                static size_t   computeFallingBlocksVertices(const GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum);
+
+                static bool     generateBlockVertices(BlockVertex* vertices, size_t& index, const size_t& maxVerticesNum,
+                                                const float& startX, const float& startY, const float& endX, const float& endY, BlockType block,
+                                                uint8_t skyLight, uint8_t blockLight);
+
+                // Returns the distance between the top of a block and the surface of the fluid that it contains
+                static inline float getFluidGap(uint8_t fluidLevel)     { return fluidLevel == 0 ? 0.0f : (1.0f - (float) fluidLevel / (float) MAX_FLUID_LEVEL) * BLOCK_HEIGHT; }
+
+                static uint64_t s_lastMeshId;                   // Id given to the last mesh built
+        };
+
+}
+
+#endif // WORLD_MESHER_H
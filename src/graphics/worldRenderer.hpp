@@ -1,7 +1,7 @@
 
 // Contains definition of the WorldRenderer class.
 // The WorldRenderer implements batch rendering to draw all the blocks (that makes up a world)
-// that are visible from a camera.
+// that are visible from a camera, the vertices of such blocks are computed by the WorldMesher.
 //
 
 #ifndef WORLD_RENDERER_H
@@ -12,6 +12,7 @@
 
 #include "log.hpp"
 #include "world/gameWorld.hpp"
+#include "renderSnapshot.hpp"
 #include "shader.hpp"
 #include "tileset.hpp"
 #include "sprite.hpp"
@@ -35,30 +36,16 @@ namespace mc2d {
                 void            terminate();
                 inline bool     isInit() const                                  { return m_isInit; }
 
-                void            render(GameWorld& world, Camera& camera, bool optimized);
+                void            render(const WorldMesh& mesh, const Camera& camera, float skyLightFactor);
 
         private:
 
-                // This struct defines the memory layout of one vertex that makes up a block,
-                // each block is made up of 6 of those (2 triangles with 3 vertices each)
-                struct BlockVertex {
-                        float   position[2];
-                        float   uv[2];
-                        float   tileId;
-                };
-
-                size_t          computeVisibleBlocksVertices(const GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum);
-                size_t          optimizedComputeVisibleBlocksVertices(const GameWorld& world, const Camera& camera, BlockVertex* vertices, const size_t maxVerticesNum, size_t& verticesNum);
-
-                bool            generateBlockVertices(BlockVertex* vertices, size_t& index, const size_t& maxVerticesNum,
-                                                const float& startX, const float& startY, const float& endX, const float& endY, BlockType block) const;
-
                 bool            m_isInit;
                 Tileset         m_blocksTileset;                // Tileset that contains the blocks textures
 
-                size_t          m_maxBlocksInBatch;             // Maximum number of blocks that can be rendered in a single draw call
-                size_t          m_currBlocksInBatch;            // Number of blocks that will be rendered in the next draw call
-                BlockVertex*    m_blocksVertices;               // Vertices data for the blocks that will be rendered in the next draw call
+                size_t          m_maxBlocksInBatch;             // Number of blocks for which there is space in the world vbo
+                size_t          m_currVerticesNum;              // Number of vertices in the world vbo
+                uint64_t        m_currMeshId;                   // Id of the mesh stored in the world vbo (zero if there is none)
                 
                 uint32_t        m_worldVao;
                 uint32_t        m_worldVbo;
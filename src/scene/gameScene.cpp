@@ -4,8 +4,9 @@
 namespace mc2d {
 
 
-        GameScene::GameScene(GameWorld&& gameWorld) : m_playerSprite(Sprite()), m_playerCamera(Camera(0.0f, 18.0f, 1.0f, 18, 18)),
-                m_gameWorld(gameWorld), m_currPlayerId(0), m_optimizedDraw(true), m_cursorBlockType(BlockType::GRASS)
+        GameScene::GameScene(GameWorld&& gameWorld) : m_worldMesh(nullptr), m_playerCamera(Camera(0.0f, 18.0f, 1.0f, 18, 18)),
+                m_gameWorld(gameWorld), m_autosaveTimer(0.0f), m_hasSaved(false), m_chunkEventsNum(0), m_isSteady(false),
+                m_currPlayerId(0), m_optimizedDraw(true), m_wireframe(false), m_cursorBlockType(BlockType::GRASS)
         {}
 
 
@@ -24,21 +25,6 @@ namespace mc2d {
                 if(isInit())
                         return 1;
 
-                // Initialize the world renderer
-                if(m_worldRenderer.init(Chunk::width * Chunk::height) != 0)
-                {
-                        logError("GameScene::init() failed, initialization of WorldRenderer failed!");
-                        return 1;
-                }
-
-                // TODO: Move this somewhere else ??? =====
-                if(!m_playerSprite.load("../resources/textures/player/steveHead.png"))
-                {
-                        logError("GameScene::init() failed, cannot load player sprite!");
-                        m_worldRenderer.terminate();
-                        return 1;
-                }//====================================
-                
                 printHelp();
                 m_isInit = true;
                 return 0;
@@ -51,17 +37,23 @@ namespace mc2d {
                 if(!isInit())
                         return;
 
-                m_worldRenderer.terminate();
+                // The world must be entirely on disk before the scene goes away (the chunks that are not loaded are written
+                // now, the edits to the loaded ones are in the block journal, written by the ChunkWriter with the chunks)
+                reportSaveResult(m_worldSaver.wait(m_gameWorld));
+                if(!m_gameWorld.getWorldSaveDirectory().empty() && !m_gameWorld.syncBlockJournal())
+                        logWarn("failed to write the block journal of the world!");
+
+                if(!m_gameWorld.flushChunkWrites())
+                        logWarn("failed to write some of the chunks that are not loaded (or the block journal)!");
 
-                m_playerSprite.deactivate();
-                m_playerSprite.unload();
+                m_worldMesh = nullptr;
                 m_isInit = false;
         }
 
 
         // Implements the logic of the game scene
         // @game: the game instance that and invoked the update of the scene
-        // @deltaTime: time passed from the last update (measured in milliseconds)
+        // @deltaTime: time passed from the last update (measured in milliseconds, always one simulation step)
         void GameScene::update(Game& game, float deltaTime)
         {
                 if(!isInit())
@@ -71,18 +63,32 @@ namespace mc2d {
                 }
 
                 // Update world
-                m_gameWorld.update(deltaTime);
+                m_gameWorld.update();
+
+                const SaveState saveState = m_worldSaver.poll(m_gameWorld);
+                m_hasSaved |= saveState != SaveState::IDLE;
+                reportSaveResult(saveState);
+
+                // Autosave: the block edits are appended to the journal of the world (by the ChunkWriter thread), the whole
+                // world gets saved (and the journal compacted) only when the journal has grown too much
+                m_autosaveTimer += deltaTime;
+                if(m_autosaveTimer >= AUTOSAVE_INTERVAL && !m_gameWorld.getWorldSaveDirectory().empty())
+                {
+                        m_autosaveTimer = 0.0f;
+                        m_hasSaved = true;
+                        if(!m_gameWorld.syncBlockJournal())
+                                logWarn("autosave failed, cannot write the block journal of the world!");
 
-                // TODO: this works for gameplay but triggers recomputation of all the vertices for all the visible blocks,
-                // doing this each frame seems a little overkill...
-                m_playerCamera.centerOnPoint(m_gameWorld.getPlayers()[m_currPlayerId].getPos());
+                        if(m_gameWorld.getBlockJournal().needsCompaction() && !m_worldSaver.isRunning())
+                                m_worldSaver.start(m_gameWorld.getWorldSaveDirectory(), m_gameWorld);
+                }
         }
 
 
         // Defines how the game scene is rendered
         // @game: the game instance that invoked the rendering of the scene
-        // @renderer: the main game renderer
-        void GameScene::render(Game& game, Renderer& renderer)
+        // @snapshot: the snapshot that describes the next frame
+        void GameScene::render(Game& game, RenderSnapshot& snapshot)
         {
                 if(!isInit())
                 {
@@ -90,10 +96,50 @@ namespace mc2d {
                         return;
                 }
 
-                m_worldRenderer.render(m_gameWorld, m_playerCamera, m_optimizedDraw);
+                // Camera and entities are stored with their last two simulated positions so that the render thread can
+                // move them smoothly at any frame rate
+                const EntityStore& entities = m_gameWorld.getEntities();
+                EntityHandle player = m_gameWorld.getPlayers()[m_currPlayerId];
+
+                m_playerCamera.centerOnPoint(entities.getPrevPos(player));
+                snapshot.prevCameraPos = m_playerCamera.getPos();
+                m_playerCamera.centerOnPoint(entities.getPos(player));
+
+                // The vertices of the visible blocks are recomputed only when something changes, otherwise the same mesh is reused
+                bool meshRebuilt = false;
+                if(m_worldMesh == nullptr || m_gameWorld.hasChanged() || m_playerCamera.hasChanged())
+                {
+                        // The render thread draws the camera a little behind the one used here, include one more block on each side
+                        Camera meshCamera = m_playerCamera;
+                        meshCamera.updatePos(-1.0f, 1.0f);
+                        meshCamera.setWidth(m_playerCamera.getWidth() + 2);
+                        meshCamera.setHeight(m_playerCamera.getHeight() + 2);
+
+                        m_worldMesh = WorldMesher::buildMesh(m_gameWorld, meshCamera, m_optimizedDraw);
+                        m_gameWorld.setHasChanged(false);
+                        m_playerCamera.setHasChanged(false);
+                        meshRebuilt = true;
+                }
 
-                for(auto& p : m_gameWorld.getPlayers()) // Draw heads of all players in the game world
-                        renderer.renderSprite(m_playerSprite, p.getPos(), glm::vec3(0.5f), 0.0f, m_playerCamera);
+                // The frame is steady if the world did not stream chunks, the mesh is reused and the snapshot already has
+                // room for the sprites (then the whole frame must not allocate, see Game::run())
+                const ChunkStreamingStats& streaming = m_gameWorld.getChunkStreamingStats();
+                const ChunkCompressionStats& compression = m_gameWorld.getChunkCompressionStats();
+                const uint64_t chunkEventsNum = streaming.loads + streaming.unloads + compression.compressions + compression.decompressions;
+
+                m_isSteady = !meshRebuilt && !m_hasSaved && chunkEventsNum == m_chunkEventsNum &&
+                        snapshot.sprites.capacity() >= m_gameWorld.getPlayers().size();
+                m_chunkEventsNum = chunkEventsNum;
+                m_hasSaved = false;
+
+                snapshot.worldMesh = m_worldMesh;
+                snapshot.skyLightFactor = m_gameWorld.getSkyLightFactor();
+                snapshot.wireframe = m_wireframe;
+                snapshot.camera = m_playerCamera;
+
+                snapshot.sprites.clear();
+                for(EntityHandle p : m_gameWorld.getPlayers()) // Draw heads of all players in the game world
+                        snapshot.sprites.push_back( { SpriteId::PLAYER_HEAD, entities.getPrevPos(p), entities.getPos(p), glm::vec3(0.5f) } );
         }
 
 
@@ -127,6 +173,7 @@ namespace mc2d {
                         case GLFW_KEY_G:
                                 if(action == GLFW_PRESS)
                                 {
+                                        reportSaveResult(m_worldSaver.wait(m_gameWorld));
                                         std::filesystem::path oldSaveDir = m_gameWorld.getWorldSaveDirectory();
                                         m_gameWorld = WorldGenerator::generateRandomWorld((unsigned) std::time(nullptr), 3);
                                         m_gameWorld.setWorldSaveDirectory(oldSaveDir);
@@ -137,6 +184,7 @@ namespace mc2d {
                         case GLFW_KEY_F:
                                 if(action == GLFW_PRESS)
                                 {
+                                        reportSaveResult(m_worldSaver.wait(m_gameWorld));
                                         std::filesystem::path oldSaveDir = m_gameWorld.getWorldSaveDirectory();
                                         m_gameWorld = WorldGenerator::generateFlatWorld(3);
                                         m_gameWorld.setWorldSaveDirectory(oldSaveDir);
@@ -147,9 +195,10 @@ namespace mc2d {
                         case GLFW_KEY_S:
                                 if(action == GLFW_PRESS && mods & GLFW_MOD_CONTROL)
                                 {
-                                        if(WorldLoader::saveWorld(m_gameWorld.getWorldSaveDirectory(), m_gameWorld))
+                                        // The world is written by a child process, the result is reported by update()
+                                        if(m_worldSaver.start(m_gameWorld.getWorldSaveDirectory(), m_gameWorld))
                                         {
-                                                logInfo("World saved successfully!");
+                                                logInfo("Saving world (the game has been stopped for %.2f ms)", m_worldSaver.getPauseDuration());
                                         } else {
                                                 logWarn("failed to save world!");
                                         }
@@ -173,12 +222,7 @@ namespace mc2d {
                         // Switch between solid and wireframe rendering
                         case GLFW_KEY_W:
                                 if(action == GLFW_PRESS)
-                                {
-                                        static bool isWireframe = false;
-
-                                        isWireframe = !isWireframe;
-                                        isWireframe == true ? glPolygonMode(GL_FRONT_AND_BACK, GL_LINE) : glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-                                }
+                                        m_wireframe = !m_wireframe;     // Applied by the render thread (see render())
                                 break;
 
                         // Switch between optimized and basic world rendering (TODO: Remove this when testing on renderer will be over)
@@ -212,15 +256,41 @@ namespace mc2d {
 
                                         logInfo("");
                                         logInfo("       ==========[ Players info ]==========");
-                                        std::vector<Entity>& players = m_gameWorld.getPlayers();
+                                        const std::vector<EntityHandle>& players = m_gameWorld.getPlayers();
                                         for(size_t i = 0; i < players.size(); ++i)
+                                        {
+                                                glm::vec3 pos = m_gameWorld.getEntities().getPos(players[i]);
                                                 logInfo("       player %d] pos: (%f, %f), contained in chunk %d", i,
-                                                        players[i].getPos().x, players[i].getPos().y, m_gameWorld.getEntityChunkId(players[i]) );
+                                                        pos.x, pos.y, m_gameWorld.getEntityChunkId(players[i]) );
+                                        }
 
                                         logInfo("");
                                         logInfo("       ==========[ Loaded chunks info ]==========");
                                         for(const auto& c : m_gameWorld.getLoadedChunks())
-                                                logInfo("       chunk %d] biome: %s", c.second.id, WorldEncyclopedia::getBiomeProperties(c.second.biome).name.c_str() );
+                                                logInfo("       chunk %d] biome: %s, %s", c.second.id, WorldEncyclopedia::getBiomeProperties(c.second.biome).name.c_str(),
+                                                        c.second.tier == ChunkTier::TICKING ? "ticking" : "frozen");
+
+                                        const ChunkCache& cache = m_gameWorld.getChunkCache();
+                                        logInfo("       cached chunks: %lu (%lu/%lu bytes), hit rate: %.1f%%", cache.getChunksNum(), cache.getUsedBytes(),
+                                                cache.getBudget(), cache.getHitRate() * 100.0f);
+
+                                        const ChunkCompressionStats& compression = m_gameWorld.getChunkCompressionStats();
+                                        logInfo("       compressed chunks saved: %lu bytes, decompressions: %lu (%.1f us each)", compression.savedBytes,
+                                                compression.decompressions, compression.getAverageDecompressionTime());
+                                        logInfo("       chunk buffers allocated: %lu, reused: %lu, pooled: %lu", ChunkBufferPool::getAllocationsNum(),
+                                                ChunkBufferPool::getReusesNum(), ChunkBufferPool::getPooledBuffersNum());
+
+                                        const ChunkWriter& writer = m_gameWorld.getChunkWriter();
+                                        logInfo("       chunk writes: %lu, pending: %lu, coalesced: %lu, stalls: %lu", writer.getWritesNum(), writer.getPendingNum(),
+                                                writer.getCoalescedNum(), writer.getStallsNum());
+                                        logInfo("       block journal records: %lu (next sequence number: %lu)", m_gameWorld.getBlockJournal().getRecordsNum(),
+                                                m_gameWorld.getBlockJournal().getNextSeq());
+
+                                        if(AllocationCounter::isEnabled())
+                                                logInfo("       heap allocations in the last frame: %lu", game.getLastFrameAllocations());
+
+                                        const ChunkStreamingStats& stats = m_gameWorld.getChunkStreamingStats();
+                                        logInfo("       chunk loads: %lu, unloads: %lu, thrash rate: %.1f%%", stats.loads, stats.unloads, stats.getThrashRate() * 100.0f);
                                 
                                         logInfo("");
                                 }
@@ -229,22 +299,29 @@ namespace mc2d {
                         // Player movement
                         case GLFW_KEY_LEFT:
                                 if(action == GLFW_PRESS || action == GLFW_REPEAT)
-                                        m_gameWorld.getPlayers()[m_currPlayerId].setAcceleration(glm::vec3(-80.0f, 0.0f, 0.0f));
+                                        m_gameWorld.getEntities().setAcceleration(m_gameWorld.getPlayers()[m_currPlayerId], glm::vec3(-80.0f, 0.0f, 0.0f));
                                 break;
 
                         case GLFW_KEY_RIGHT:
                                 if(action == GLFW_PRESS || action == GLFW_REPEAT)
-                                        m_gameWorld.getPlayers()[m_currPlayerId].setAcceleration(glm::vec3(80.0f, 0.0f, 0.0f));
+                                        m_gameWorld.getEntities().setAcceleration(m_gameWorld.getPlayers()[m_currPlayerId], glm::vec3(80.0f, 0.0f, 0.0f));
                                 break;
 
                         case GLFW_KEY_UP:
                                 if(action == GLFW_PRESS || action == GLFW_REPEAT)
-                                        m_gameWorld.getPlayers()[m_currPlayerId].setAcceleration(glm::vec3(0.0f, 80.0f, 0.0f));
+                                {
+                                        // Players can jump only while they are standing on a block
+                                        EntityStore& entities = m_gameWorld.getEntities();
+                                        EntityHandle player = m_gameWorld.getPlayers()[m_currPlayerId];
+
+                                        if(entities.isGrounded(player))
+                                                entities.setVelocity(player, glm::vec3(entities.getVelocity(player).x, PLAYER_JUMP_VELOCITY, 0.0f));
+                                }
                                 break;
 
                         case GLFW_KEY_DOWN:
                                 if(action == GLFW_PRESS || action == GLFW_REPEAT)
-                                        m_gameWorld.getPlayers()[m_currPlayerId].setAcceleration(glm::vec3(0.0f, -80.0f, 0.0f));
+                                        m_gameWorld.getEntities().setAcceleration(m_gameWorld.getPlayers()[m_currPlayerId], glm::vec3(0.0f, -80.0f, 0.0f));
                                 break;
 
                         // Camera resize
@@ -267,7 +344,7 @@ namespace mc2d {
                         // Spawn new player in the game world
                         case GLFW_KEY_P:
                                 if(action == GLFW_PRESS)
-                                        m_gameWorld.getPlayers().push_back( Entity(glm::vec3(0.0f), 100.0f, EntityType::PLAYER) );
+                                        m_gameWorld.addPlayer( Entity(glm::vec3(0.0f), 100.0f, EntityType::PLAYER) );
                                 break;
 
                         // Switch to the previous available player in the game world
@@ -332,6 +409,32 @@ namespace mc2d {
 
                         m_gameWorld.setBlock(blockCoord.x, blockCoord.y, m_cursorBlockType);
                 }
+
+                // On middle mouse click ignite a block (TNT)
+                if(btn == GLFW_MOUSE_BUTTON_MIDDLE && action == GLFW_PRESS)
+                {
+                        double mouseX, mouseY;
+                        glfwGetCursorPos(wnd, &mouseX, &mouseY);
+
+                        // Convert window coordinates into world coordinates
+                        glm::vec2 blockCoord = m_playerCamera.windowToWorldCoord((float) mouseX, (float) mouseY,
+                                        (float) game.getSettings().windowWidth, (float) game.getSettings().windowHeight);
+
+                        m_gameWorld.igniteBlock(blockCoord.x, blockCoord.y);
+                }
+        }
+
+
+        // Prints the result of a background save of the world (if it has finished)
+        // @result: state returned by the world saver
+        void GameScene::reportSaveResult(SaveState result) const
+        {
+                if(result == SaveState::SUCCEEDED)
+                {
+                        logInfo("World saved successfully!");
+                } else if(result == SaveState::FAILED) {
+                        logWarn("failed to save world!");
+                }
         }
 
 
@@ -351,10 +454,11 @@ namespace mc2d {
                 logInfo("Block controls:");
                 logInfo("       - left mouse click to delete a block");
                 logInfo("       - right mouse click to place a block");
+                logInfo("       - middle mouse click to ignite a TNT block");
                 logInfo("       - press 1 and 2 to change the block type that will be placed");
 
                 logInfo("Player/camera controls:");
-                logInfo("       - use arrows to move the player around");
+                logInfo("       - use arrows to move the player around (up arrow to jump)");
                 logInfo("       - use keypad + and keypad - to change camera size");
                 logInfo("       - use P to spawn another player")
                 logInfo("       - use Z and X to switch between players in the world");
@@ -12,8 +12,10 @@
 #include "scene.hpp"
 #include "world/gameWorld.hpp"
 #include "world/worldGenerator.hpp"
+#include "world/forkedWorldSaver.hpp"
 #include "graphics/renderer.hpp"
-#include "graphics/worldRenderer.hpp"
+#include "graphics/worldMesher.hpp"
+#include "graphics/renderSnapshot.hpp"
 #include "graphics/camera.hpp"
 #include "graphics/sprite.hpp"
 
@@ -23,6 +25,9 @@
 namespace mc2d {
 
 
+        constexpr float AUTOSAVE_INTERVAL = 5'000.0f;          // Time between two autosaves of the block edits (in milliseconds)
+
+
         class GameScene : public Scene {
         public:
                 GameScene(GameWorld&& gameWorld);
@@ -32,22 +37,28 @@ namespace mc2d {
                 virtual void    terminate();
 
                 virtual void    update(Game& game, float deltaTime);
-                virtual void    render(Game& game, Renderer& renderer);
+                virtual void    render(Game& game, RenderSnapshot& snapshot);
+                virtual bool    isSteady() const        { return m_isSteady; }
 
                 virtual void    onKeyEvent(Game& game, GLFWwindow* wnd, int key, int scancode, int action, int mods);
                 virtual void    onMouseButtonEvent(Game& game, GLFWwindow* wnd, int btn, int action, int modifiers);
 
         private:
                 void            printHelp() const;
+                void            reportSaveResult(SaveState result) const;
 
-                Sprite          m_playerSprite;         // TODO: move this somewhere else ???
-                
-                WorldRenderer   m_worldRenderer;
+                std::shared_ptr<const WorldMesh> m_worldMesh;   // Mesh of the blocks visible from the camera (rebuilt when world or camera change)
                 Camera          m_playerCamera;         // Camera focused on player
                 GameWorld       m_gameWorld;
+                ForkedWorldSaver m_worldSaver;          // Saves the world in the background (Ctrl + S)
+                float           m_autosaveTimer;        // Time passed since the last autosave (in milliseconds)
+                bool            m_hasSaved;             // True if the world has been saved (or a save has been running) since the last render
+                uint64_t        m_chunkEventsNum;       // Chunks loaded, unloaded, compressed and decompressed by the world until the last render
+                bool            m_isSteady;             // True if the last frame did not stream chunks, rebuild the mesh or save the world
         
                 size_t          m_currPlayerId;         // Indicates which player in the game world we are currently controlling
                 bool            m_optimizedDraw;        // TODO: remove me when testing is over
+                bool            m_wireframe;            // True if the world is drawn in wireframe (switched with the W key)
                 BlockType       m_cursorBlockType;      // Which type of block will be placed in the world when right mouse is clicked
         };
 }
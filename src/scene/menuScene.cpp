@@ -92,9 +92,11 @@ namespace mc2d {
 
         // Defines how the menu scene is rendered
         // @game: the game instance that invoked the rendering of the scene
-        // @renderer: the main game renderer
-        void MenuScene::render(Game& game, Renderer& renderer)
+        // @snapshot: the snapshot that describes the next frame
+        void MenuScene::render(Game& game, RenderSnapshot& snapshot)
         {
+                snapshot.clear();                               // The menu is printed in the terminal, nothing is drawn in the window
+
                 // TODO: this is a temporary terminal based implementation, need to add GUI
                 if(m_renderMenu)
                 {
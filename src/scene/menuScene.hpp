@@ -29,7 +29,7 @@ namespace mc2d {
                 virtual void    terminate();
 
                 virtual void    update(Game& game, float deltaTime);
-                virtual void    render(Game& game, Renderer& renderer);
+                virtual void    render(Game& game, RenderSnapshot& snapshot);
 
                 virtual void    onKeyEvent(Game& game, GLFWwindow* wnd, int key, int scancode, int action, int mods);
                 virtual void    onMouseButtonEvent(Game& game, GLFWwindow* wnd, int btn, int action, int modifiers);
@@ -4,6 +4,8 @@
 // The Scene interface is used to abstract a "phase" of the game, in particular the classes that
 // implement this interface will define the way in which the player/user can interact with
 // the game and the way in which the game will be updated and rendered each frame.
+// Both update and render are invoked on the simulation thread, render only describes the frame in a
+// snapshot that is then drawn by the render thread (scenes never use OpenGL directly).
 //
 // In this way we can switch between different game phases ,for example menu and in-game, by simply
 // changing the current scene in the Game class.
@@ -17,7 +19,7 @@ struct GLFWwindow;
 namespace mc2d {
 
         class Game;
-        class Renderer;
+        struct RenderSnapshot;
 
         class Scene {
         public:
@@ -30,7 +32,11 @@ namespace mc2d {
                 inline bool     isInit() const  { return m_isInit; }
 
                 virtual void    update(Game& game, float deltaTime) = 0;
-                virtual void    render(Game& game, Renderer& renderer) = 0;
+                virtual void    render(Game& game, RenderSnapshot& snapshot) = 0;
+
+                // Returns true if the last frame of the scene (its updates and its render) did only work that must not
+                // allocate memory, Game::run() checks these frames with a ZeroAllocationScope
+                virtual bool    isSteady() const                { return false; }
 
                 virtual void    onKeyEvent(Game& game, GLFWwindow* wnd, int key, int scancode, int action, int mods) = 0;
                 virtual void    onMouseButtonEvent(Game& game, GLFWwindow* wnd, int btn, int action, int modifiers) = 0;
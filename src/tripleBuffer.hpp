@@ -0,0 +1,72 @@
+
+// Contains definition of the TripleBuffer class, this class is used to pass data from one thread (the writer) to another
+// one (the reader) without locks.
+//
+// The buffer is made up of three instances of the data: the writer fills the back one while the reader uses the front one,
+// the third one (the middle one) holds the last data published. Publishing swaps the back and the middle instances, acquiring
+// swaps the front and the middle instances (only if something new has been published), both swaps are a single atomic
+// exchange so neither of the two threads ever waits for the other one. The reader always gets the most recent data and the
+// writer never overwrites the data that the reader is using; data published while the reader is busy is skipped.
+//
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace mc2d {
+
+
+        template <typename T>
+        class TripleBuffer {
+        public:
+                TripleBuffer() : m_middle(1), m_back(0), m_front(2)
+                {}
+
+                ~TripleBuffer() = default;
+
+                // Delete copy constructors
+                TripleBuffer(TripleBuffer& other) = delete;
+                TripleBuffer(const TripleBuffer& other) = delete;
+                TripleBuffer operator = (TripleBuffer& other) = delete;
+                TripleBuffer operator = (const TripleBuffer& other) = delete;
+
+                // Returns the instance that the writer can fill (must be called only by the writer)
+                inline T&               getWriteBuffer()                { return m_buffers[m_back]; }
+
+                // Returns the instance acquired by the reader (must be called only by the reader)
+                inline const T&         getReadBuffer() const           { return m_buffers[m_front]; }
+
+                // Makes the data in the write buffer available to the reader (must be called only by the writer), the write
+                // buffer is replaced by the instance that was published before (or that has been released by the reader)
+                inline void             publish()
+                {
+                        m_back = m_middle.exchange(m_back | NEW_DATA_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+                }
+
+                // Makes the last data published available in the read buffer (must be called only by the reader)
+                // @returns: true if new data has been acquired, false if nothing has been published since the last call
+                inline bool             acquire()
+                {
+                        if((m_middle.load(std::memory_order_relaxed) & NEW_DATA_BIT) == 0)
+                                return false;
+
+                        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+                        return true;
+                }
+
+        private:
+
+                static constexpr uint8_t NEW_DATA_BIT = 0x4;    // Set in m_middle when it holds data that the reader has not acquired yet
+                static constexpr uint8_t INDEX_MASK = 0x3;
+
+                T                       m_buffers[3];
+                std::atomic<uint8_t>    m_middle;               // Index of the instance shared by the two threads (and the NEW_DATA_BIT)
+                uint8_t                 m_back;                 // Index of the instance owned by the writer
+                uint8_t                 m_front;                // Index of the instance owned by the reader
+        };
+
+}
+
+#endif // TRIPLE_BUFFER_H
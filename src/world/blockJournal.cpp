@@ -0,0 +1,206 @@
+
+#include "blockJournal.hpp"
+#include "gameWorld.hpp"
+
+namespace mc2d {
+
+
+        static constexpr uint32_t JOURNAL_VERSION = 1;          // Version of the format of the journal file
+
+
+        BlockJournal::BlockJournal() : m_writtenNum(0), m_nextSeq(0), m_needsRewrite(true)
+        {}
+
+
+        // Records a block edit
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: new type of the block
+        void BlockJournal::record(int x, int y, BlockType block)
+        {
+                m_records.push_back( { m_nextSeq++, x, y, block } );
+        }
+
+
+        // Applies to a chunk that has just been loaded from its file (or generated) the edits that are not contained in it
+        // @chunk: the chunk (must not be compressed)
+        // @returns: the number of edits applied
+        size_t BlockJournal::replay(Chunk& chunk)
+        {
+                // The edits recorded from now on must come after the ones already contained in the chunk (the edits made
+                // after the last write of the journal are lost in a crash, so their sequence numbers could be reused)
+                m_nextSeq = std::max(m_nextSeq, chunk.journalSeq);
+
+                size_t replayedNum = 0;
+                for(const JournalRecord& r : m_records)
+                {
+                        if(r.seq < chunk.journalSeq || Chunk::getIdFromBlockX(r.x) != chunk.id)
+                                continue;
+
+                        const size_t index = chunk.getBlockIndex(r.x, r.y);
+                        chunk.blocks[index] = r.block;
+                        if(chunk.fluidLevels.size() == chunk.blocks.size())
+                                chunk.fluidLevels[index] = FluidSimulator::isFluid(r.block) ? MAX_FLUID_LEVEL : 0;
+
+                        ++replayedNum;
+                }
+
+                if(replayedNum != 0)
+                        chunk.invalidateSnapshot();
+
+                return replayedNum;
+        }
+
+
+        // Drops the edits contained in the chunk files written by a save of the whole world (the journal file must be rewritten
+        // after this)
+        // @savedSeq: sequence number of the next edit when the save has been started
+        void BlockJournal::compact(uint64_t savedSeq)
+        {
+                auto firstKept = std::find_if(m_records.begin(), m_records.end(), [savedSeq](const JournalRecord& r) { return r.seq >= savedSeq; });
+                m_records.erase(m_records.begin(), firstKept);
+
+                m_writtenNum = 0;
+                m_needsRewrite = true;
+        }
+
+
+        // Drops all the records (the sequence numbers keep growing)
+        void BlockJournal::clear()
+        {
+                m_records.clear();
+                m_writtenNum = 0;
+                m_needsRewrite = true;
+        }
+
+
+        // Takes the records that must be written in the journal file: the new ones, or all of them if the file must be
+        // rewritten. They are considered written from now on (if the write fails setNeedsRewrite() must be called)
+        // @batch: the records are copied in here
+        // @returns: true if there is something to write, false otherwise
+        bool BlockJournal::takeNewRecords(JournalBatch& batch)
+        {
+                if(!hasNewRecords())
+                        return false;
+
+                batch.rewrite = m_needsRewrite;
+                batch.nextSeq = m_nextSeq;
+                batch.records.assign(m_records.begin() + (m_needsRewrite ? 0 : m_writtenNum), m_records.end());
+
+                m_writtenNum = m_records.size();
+                m_needsRewrite = false;
+                return true;
+        }
+
+
+        // Writes the records of a batch in the given file, the header of the journal is written first if the batch rewrites
+        // the file
+        // @file: output file stream in which the records will be written (opened in append mode if the batch does not rewrite the file)
+        // @batch: the records taken from the journal
+        // @returns: true if serialization is successfull, false otherwise
+        bool BlockJournal::serialize(std::ofstream& file, const JournalBatch& batch)
+        {
+                if(!file.good())
+                {
+                        logError("BlockJournal::serialize() failed, the given file stream is broken!");
+                        return false;
+                }
+
+                // A rewritten file starts with the version of the format and the next sequence number (it is kept even if
+                // there are no records)
+                if(batch.rewrite)
+                        file << JOURNAL_VERSION << ' ' << batch.nextSeq << '\n';
+
+                bool res = file.good();
+                for(auto r = batch.records.begin(); r != batch.records.end() && res != false; ++r)
+                        res = serializeRecord(file, *r);
+
+                return res;
+        }
+
+
+        // Reads the journal from the given file, the records after the first one that is incomplete or corrupted are ignored
+        // @file: input file stream from which the journal will be read
+        // @returns: true if deserialization is successfull, false otherwise
+        bool BlockJournal::deserialize(std::ifstream& file)
+        {
+                if(!file.good())
+                {
+                        logError("BlockJournal::deserialize() failed, the given file stream is broken!");
+                        return false;
+                }
+
+                uint32_t version;
+                uint64_t nextSeq;
+                file >> version;
+                file >> nextSeq;
+
+                if(!file.good() || version != JOURNAL_VERSION)
+                {
+                        logError("BlockJournal::deserialize() failed, cannot read journal properties (or unknown version)!");
+                        return false;
+                }
+
+                std::vector<JournalRecord> records;
+                bool complete = true;
+                while(true)
+                {
+                        JournalRecord r;
+                        uint32_t block, checksum;
+                        if(!(file >> r.seq))
+                        {
+                                complete = file.eof();
+                                break;
+                        }
+
+                        file >> r.x; file >> r.y; file >> block; file >> checksum;
+                        r.block = static_cast<BlockType>(block);
+
+                        if(file.fail() || r.y < 0 || r.y >= (int) Chunk::height || computeChecksum(r) != checksum ||
+                                (!records.empty() && r.seq <= records.back().seq))
+                        {
+                                complete = false;
+                                break;
+                        }
+
+                        nextSeq = std::max(nextSeq, r.seq + 1);
+                        records.push_back(r);
+                }
+
+                if(!complete)
+                        logWarn("BlockJournal::deserialize(), the journal has been cut after %lu records (probably by a crash), the rest is ignored!", records.size());
+
+                m_records = std::move(records);
+                m_nextSeq = nextSeq;
+                m_writtenNum = m_records.size();
+                m_needsRewrite = !complete;
+                return true;
+        }
+
+
+        // Returns the checksum of a record (used to find the records cut by a crash)
+        uint32_t BlockJournal::computeChecksum(const JournalRecord& r)
+        {
+                uint32_t h = 2166136261u;
+                const uint64_t values[] = { r.seq, (uint64_t) (uint32_t) r.x, (uint64_t) (uint32_t) r.y, (uint64_t) r.block };
+                for(uint64_t v : values)
+                {
+                        for(size_t i = 0; i < sizeof(v); ++i)
+                        {
+                                h ^= (uint8_t) (v >> (i * 8));
+                                h *= 16777619u;
+                        }
+                }
+
+                return h;
+        }
+
+
+        // Writes one record (as a line that ends with its checksum)
+        bool BlockJournal::serializeRecord(std::ofstream& file, const JournalRecord& r)
+        {
+                file << r.seq << ' ' << r.x << ' ' << r.y << ' ' << static_cast<uint32_t>(r.block) << ' ' << computeChecksum(r) << '\n';
+                return file.good();
+        }
+
+}
@@ -0,0 +1,85 @@
+
+// Contains definition of the BlockJournal class, this class keeps an append-only log of the block edits made in a game
+// world so that they survive a crash without rewriting the chunk files.
+//
+// Each edit gets a sequence number, a chunk file keeps the sequence number of the first edit that it does not contain
+// (see Chunk::journalSeq). When a chunk is loaded from its file (or generated again) the edits recorded for it from that
+// number on are replayed. The new edits are appended to the "journal.dat" file of the world by the autosave, the chunk
+// files are rewritten only when the whole world gets saved, then the edits contained in the saved files are dropped from
+// the journal (compaction).
+// The journal file is never written by the simulation thread: the autosave takes the new records (or all of them when the
+// file must be rewritten) in a JournalBatch that the ChunkWriter thread writes and syncs (see WorldLoader::appendJournal()).
+// Each record is written with a checksum, a record cut by a crash and the ones after it are ignored when the journal is read.
+// Used only by the simulation thread.
+//
+
+#ifndef BLOCK_JOURNAL_H
+#define BLOCK_JOURNAL_H
+
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+        struct Chunk;
+
+
+        constexpr size_t JOURNAL_COMPACTION_RECORDS = 16'384;   // Number of records after which the journal should be compacted
+
+
+        struct JournalRecord {
+                uint64_t                seq;                    // Sequence number of the edit
+                int                     x;                      // X coordinate of the block in world space
+                int                     y;                      // Y coordinate of the block in world space
+                BlockType               block;                  // New type of the block
+        };
+
+
+        // Records taken from the journal to be written in its file by another thread (see BlockJournal::takeNewRecords())
+        struct JournalBatch {
+                std::vector<JournalRecord> records;
+                uint64_t                nextSeq = 0;            // Sequence number of the next edit (written in the header of a rewritten file)
+                bool                    rewrite = false;        // If true the file is rewritten with the records, otherwise they are appended to it
+        };
+
+
+        class BlockJournal {
+        public:
+                BlockJournal();
+
+                void                    record(int x, int y, BlockType block);
+                size_t                  replay(Chunk& chunk);
+                void                    compact(uint64_t savedSeq);
+                void                    clear();
+                bool                    takeNewRecords(JournalBatch& batch);
+
+                // Forces the next write of the journal to rewrite the whole file (used when the world moves to another directory)
+                inline void             setNeedsRewrite()                       { m_needsRewrite = true; }
+
+                inline bool             needsRewrite() const                    { return m_needsRewrite; }
+                inline bool             hasNewRecords() const                   { return m_needsRewrite || m_writtenNum < m_records.size(); }
+                inline bool             needsCompaction() const                 { return m_records.size() >= JOURNAL_COMPACTION_RECORDS; }
+                inline uint64_t         getNextSeq() const                      { return m_nextSeq; }
+                inline size_t           getRecordsNum() const                   { return m_records.size(); }
+
+                static bool             serialize(std::ofstream& file, const JournalBatch& batch);
+                bool                    deserialize(std::ifstream& file);
+
+        private:
+
+                static uint32_t         computeChecksum(const JournalRecord& r);
+                static bool             serializeRecord(std::ofstream& file, const JournalRecord& r);
+
+                std::vector<JournalRecord> m_records;           // Edits recorded since the last compaction (ordered by sequence number)
+                size_t                  m_writtenNum;           // Number of records already handed over to be written in the journal file
+                uint64_t                m_nextSeq;              // Sequence number of the next edit
+                bool                    m_needsRewrite;         // True if the journal file must be rewritten entirely (missing, cut by a crash or in another directory)
+        };
+
+}
+
+#endif // BLOCK_JOURNAL_H
@@ -17,6 +17,8 @@ namespace mc2d {
         constexpr float BLOCK_WIDTH = 1.0f;
         constexpr float BLOCK_HEIGHT = 1.0f;
 
+        constexpr uint8_t MAX_LIGHT_LEVEL = 15;         // Light levels (both sky light and block light) are in range [0, MAX_LIGHT_LEVEL]
+
 
         // Note: If you change this enum make sure to update the look-up table in WorldEncyclopedia class too (in worldEncyclopeida.cpp) and keep the same order of elements!
         // Remember to update "resources/myTileset.png" too.
@@ -112,6 +114,14 @@ namespace mc2d {
                 BLOCK_TYPE_MAX          // Keep me last!!!
         };
 
+
+        // Defines the change of one block, used to apply many changes in one single batch
+        struct BlockEdit {
+                int             x;              // X coordinate of the block in world space
+                int             y;              // Y coordinate of the block in world space
+                BlockType       block;          // New type of the block
+        };
+
 }
 
 #endif // BLOCK_TYPES_H
@@ -0,0 +1,80 @@
+
+#include "chunkBufferPool.hpp"
+#include "gameWorld.hpp"
+
+namespace mc2d {
+
+
+        std::vector<std::vector<BlockType>>     ChunkBufferPool::s_blockBuffers;
+        std::vector<std::vector<uint8_t>>       ChunkBufferPool::s_levelBuffers;
+        uint64_t                                ChunkBufferPool::s_allocations = 0;
+        uint64_t                                ChunkBufferPool::s_reuses = 0;
+
+
+        // Takes a buffer from the given list (or allocates a new one if the list is empty)
+        // @buffers: the free buffers
+        // @returns: an empty buffer that can contain one value for each block of a chunk
+        template <typename T>
+        static std::vector<T> acquireBuffer(std::vector<std::vector<T>>& buffers, uint64_t& allocations, uint64_t& reuses)
+        {
+                if(buffers.empty())
+                {
+                        std::vector<T> buffer;
+                        buffer.reserve(Chunk::width * Chunk::height);
+                        ++allocations;
+                        return buffer;
+                }
+
+                std::vector<T> buffer = std::move(buffers.back());
+                buffers.pop_back();
+                ++reuses;
+                return buffer;
+        }
+
+
+        // Gives a buffer back to the given list, buffers with the wrong capacity (or that do not fit in the list) are freed
+        // @buffers: the free buffers
+        // @buffer: the buffer (it is left empty)
+        template <typename T>
+        static void releaseBuffer(std::vector<std::vector<T>>& buffers, std::vector<T>& buffer)
+        {
+                if(buffer.capacity() == Chunk::width * Chunk::height && buffers.size() < MAX_POOLED_CHUNK_BUFFERS)
+                {
+                        buffer.clear();
+                        buffers.push_back(std::move(buffer));
+                }
+
+                buffer = std::vector<T>();
+        }
+
+
+        // Returns an empty array of blocks with room for all the blocks of a chunk
+        std::vector<BlockType> ChunkBufferPool::acquireBlocks()
+        {
+                return acquireBuffer(s_blockBuffers, s_allocations, s_reuses);
+        }
+
+
+        // Returns an empty array of levels (fluid or light) with room for all the blocks of a chunk
+        std::vector<uint8_t> ChunkBufferPool::acquireLevels()
+        {
+                return acquireBuffer(s_levelBuffers, s_allocations, s_reuses);
+        }
+
+
+        // Gives an array of blocks back to the pool
+        // @buffer: the array (it is left empty and without memory)
+        void ChunkBufferPool::release(std::vector<BlockType>& buffer)
+        {
+                releaseBuffer(s_blockBuffers, buffer);
+        }
+
+
+        // Gives an array of levels back to the pool
+        // @buffer: the array (it is left empty and without memory)
+        void ChunkBufferPool::release(std::vector<uint8_t>& buffer)
+        {
+                releaseBuffer(s_levelBuffers, buffer);
+        }
+
+}
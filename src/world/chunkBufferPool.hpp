@@ -0,0 +1,51 @@
+
+// Contains definition of the ChunkBufferPool class, this class recycles the arrays that contain one value for each block
+// of a chunk (blocks, fluid levels and light levels).
+//
+// All those arrays have the same size, so instead of freeing them when a chunk gets unloaded, compressed or evicted they
+// are given back to the pool and the next chunk that is loaded, decompressed or generated takes them from there. Once the
+// pool has warmed up streaming chunks in and out of memory does not allocate any block array.
+// The pool counts the buffers that it had to allocate (because it was empty) and the ones that it reused. It must be used
+// only by the thread that runs the simulation.
+//
+
+#ifndef CHUNK_BUFFER_POOL_H
+#define CHUNK_BUFFER_POOL_H
+
+#include <vector>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+
+        constexpr size_t MAX_POOLED_CHUNK_BUFFERS = 512;        // Maximum number of buffers of each type kept by the pool (the others are freed)
+
+
+        class ChunkBufferPool {
+        public:
+                ChunkBufferPool() = delete;
+                ~ChunkBufferPool() = delete;
+
+                static std::vector<BlockType>   acquireBlocks();
+                static std::vector<uint8_t>     acquireLevels();
+                static void                     release(std::vector<BlockType>& buffer);
+                static void                     release(std::vector<uint8_t>& buffer);
+
+                static inline uint64_t          getAllocationsNum()     { return s_allocations; }
+                static inline uint64_t          getReusesNum()          { return s_reuses; }
+                static inline size_t            getPooledBuffersNum()   { return s_blockBuffers.size() + s_levelBuffers.size(); }
+
+        private:
+
+                static std::vector<std::vector<BlockType>>      s_blockBuffers;         // Free arrays of blocks
+                static std::vector<std::vector<uint8_t>>        s_levelBuffers;         // Free arrays of fluid or light levels
+                static uint64_t                                 s_allocations;          // Number of buffers allocated because the pool was empty
+                static uint64_t                                 s_reuses;               // Number of buffers taken from the pool
+        };
+
+}
+
+#endif // CHUNK_BUFFER_POOL_H
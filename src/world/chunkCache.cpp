@@ -0,0 +1,159 @@
+
+#include "chunkCache.hpp"
+#include "gameWorld.hpp"
+#include "worldLoader.hpp"
+
+namespace mc2d {
+
+
+        ChunkCache::ChunkCache() : m_budget(DEFAULT_CHUNK_CACHE_BUDGET), m_usedBytes(0), m_compress(true), m_evictionPaused(false), m_hits(0), m_misses(0)
+        {}
+
+
+        ChunkCache::~ChunkCache() = default;
+
+
+        // Adds a chunk that has just been unloaded to the cache (as the most recent one), then evicts the least recent chunks
+        // if the cache uses more memory than its budget
+        // @world: the world that unloaded the chunk (evicted chunks are saved in its directory)
+        // @chunk: the unloaded chunk
+        void ChunkCache::insert(GameWorld& world, Chunk&& chunk)
+        {
+                auto old = m_entries.find(chunk.id);
+                if(old != m_entries.end())
+                {
+                        logWarn("ChunkCache::insert() failed, chunk %d is already in the cache, the old copy has been replaced!", chunk.id);
+                        old->second.chunk->releaseBuffers();
+                        *old->second.chunk = Chunk();
+                        remove(old);
+                }
+
+                if(m_compress)
+                        chunk.compress();
+
+                // The nodes of the chunks removed before are reused (so that caching a chunk does not allocate them)
+                if(m_freeChunks.empty())
+                        m_chunks.push_front(std::move(chunk));
+                else
+                {
+                        m_chunks.splice(m_chunks.begin(), m_freeChunks, m_freeChunks.begin());
+                        m_chunks.front() = std::move(chunk);
+                }
+
+                const size_t bytes = m_chunks.front().getMemoryUsage();
+                const Entry entry = { m_chunks.begin(), bytes };
+                if(m_freeEntries.empty())
+                        m_entries[m_chunks.front().id] = entry;
+                else
+                {
+                        auto node = std::move(m_freeEntries.back());
+                        m_freeEntries.pop_back();
+
+                        node.key() = m_chunks.front().id;
+                        node.mapped() = entry;
+                        m_entries.insert(std::move(node));
+                }
+
+                m_usedBytes += bytes;
+                evict(world);
+        }
+
+
+        // Takes a chunk out of the cache (decompressed)
+        // @id: id of the chunk
+        // @chunk: if the chunk is in the cache it is moved in here
+        // @returns: true if the chunk was in the cache, false otherwise
+        bool ChunkCache::take(int id, Chunk& chunk)
+        {
+                auto e = m_entries.find(id);
+                if(e == m_entries.end())
+                {
+                        ++m_misses;
+                        return false;
+                }
+
+                chunk = std::move(*e->second.chunk);
+                chunk.decompress();
+                remove(e);
+
+                ++m_hits;
+                return true;
+        }
+
+
+        // Saves all the cached chunks in the directory of the given world (they stay in the cache)
+        // @world: the world that owns the cache
+        // @returns: true if all the chunks have been saved, false otherwise
+        bool ChunkCache::save(const GameWorld& world) const
+        {
+                bool res = true;
+                for(auto c = m_chunks.begin(); c != m_chunks.end() && res != false; ++c)
+                        res = WorldLoader::saveChunk(world.m_pathToWorldDir, *c);
+
+                return res;
+        }
+
+
+        // Queues all the cached chunks to be written (see ChunkWriter) and empties the cache, even if eviction is paused
+        // @world: the world that owns the cache (the chunks are saved in its directory)
+        void ChunkCache::flush(GameWorld& world)
+        {
+                while(!m_chunks.empty())
+                        writeOldest(world);
+        }
+
+
+        // Changes the maximum amount of memory used by the cached chunks, evicting chunks if needed
+        // @world: the world that owns the cache (evicted chunks are saved in its directory)
+        // @bytes: the new budget (zero disables the cache)
+        void ChunkCache::setBudget(GameWorld& world, size_t bytes)
+        {
+                m_budget = bytes;
+                evict(world);
+        }
+
+
+        // Stops (or restarts) writing the evicted chunks to disk, when eviction is resumed the chunks over the budget are evicted
+        // @world: the world that owns the cache (evicted chunks are saved in its directory)
+        // @paused: true to stop the eviction, false to restart it
+        void ChunkCache::setEvictionPaused(GameWorld& world, bool paused)
+        {
+                m_evictionPaused = paused;
+                evict(world);
+        }
+
+
+        // Queues the least recent chunks to be written (see ChunkWriter) and removes them until the cache fits in its budget
+        // @world: the world in whose directory the chunks are saved
+        void ChunkCache::evict(GameWorld& world)
+        {
+                while(m_usedBytes > m_budget && !m_chunks.empty() && !m_evictionPaused)
+                        writeOldest(world);
+        }
+
+
+        // Queues the least recent chunk to be written and removes it from the cache
+        // @world: the world in whose directory the chunk is saved
+        void ChunkCache::writeOldest(GameWorld& world)
+        {
+                // The chunk is compressed before being queued so that its arrays go back to the ChunkBufferPool here (the pool
+                // must not be used by the writer thread) and the queue stays small
+                Chunk& c = m_chunks.back();
+                const int id = c.id;
+                c.compress();
+                world.m_chunkWriter.write(world.m_pathToWorldDir, std::move(c));
+
+                c = Chunk();
+                remove(m_entries.find(id));
+        }
+
+
+        // Removes a chunk from the cache, the nodes that contained it are kept to be reused by the next chunk inserted
+        // @e: the entry of the chunk
+        void ChunkCache::remove(std::unordered_map<int, Entry>::iterator e)
+        {
+                m_usedBytes -= e->second.bytes;
+                m_freeChunks.splice(m_freeChunks.begin(), m_chunks, e->second.chunk);
+                m_freeEntries.push_back(m_entries.extract(e));
+        }
+}
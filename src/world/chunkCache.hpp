@@ -0,0 +1,91 @@
+
+// Contains definition of the ChunkCache class, this class keeps in memory the chunks that have been unloaded recently so
+// that they can be loaded again without reading (or generating) them.
+//
+// The cache has a budget measured in bytes: when the chunks in it use more memory than the budget the least recently
+// unloaded ones are evicted (written to disk). Chunks can be compressed while they are in the cache (see Chunk::compress()),
+// they are decompressed when they are taken out. The cache counts its hits and misses, a player that goes back and forth
+// between the same chunks should only hit the cache. The nodes of the chunks taken out of the cache are kept and reused,
+// once the cache is warm inserting and taking chunks does not allocate memory (apart from the compressed data).
+// Eviction can be paused while another process or thread is writing the chunk files (see ForkedWorldSaver), the cache then
+// grows over its budget until eviction is resumed.
+// A cache cannot be copied: its chunks can be newer than their files, two copies would both write them. flush() writes all
+// the cached chunks and empties the cache.
+//
+
+#ifndef CHUNK_CACHE_H
+#define CHUNK_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+        struct Chunk;
+
+
+        constexpr size_t DEFAULT_CHUNK_CACHE_BUDGET = 2 * 1024 * 1024;  // Default maximum amount of memory used by the cached chunks (in bytes)
+
+
+        class ChunkCache {
+        public:
+                ChunkCache();
+                ChunkCache(const ChunkCache& other) = delete;
+                ChunkCache(ChunkCache&& other) = default;
+                ~ChunkCache();
+
+                ChunkCache&             operator = (const ChunkCache& other) = delete;
+                ChunkCache&             operator = (ChunkCache&& other) = default;
+
+                void                    insert(GameWorld& world, Chunk&& chunk);
+                bool                    take(int id, Chunk& chunk);
+                bool                    save(const GameWorld& world) const;
+                void                    flush(GameWorld& world);
+
+                void                    setBudget(GameWorld& world, size_t bytes);
+                void                    setEvictionPaused(GameWorld& world, bool paused);
+                inline void             setCompression(bool compress)           { m_compress = compress; }
+
+                inline size_t           getBudget() const                       { return m_budget; }
+                inline size_t           getUsedBytes() const                    { return m_usedBytes; }
+                inline size_t           getChunksNum() const                    { return m_chunks.size(); }
+                inline bool             isCompressionEnabled() const            { return m_compress; }
+                inline bool             isEvictionPaused() const                { return m_evictionPaused; }
+                inline uint64_t         getHits() const                         { return m_hits; }
+                inline uint64_t         getMisses() const                       { return m_misses; }
+
+                // Returns the fraction of the lookups that found their chunk in the cache
+                inline float            getHitRate() const                      { return m_hits + m_misses == 0 ? 0.0f : (float) m_hits / (float) (m_hits + m_misses); }
+
+        private:
+
+                // Position of a cached chunk in the recency list and memory that it uses
+                struct Entry {
+                        std::list<Chunk>::iterator      chunk;
+                        size_t                          bytes;
+                };
+
+                void                    evict(GameWorld& world);
+                void                    writeOldest(GameWorld& world);
+                void                    remove(std::unordered_map<int, Entry>::iterator e);
+
+                std::list<Chunk>                        m_chunks;               // Cached chunks, from the most recently unloaded to the least recent one
+                std::unordered_map<int, Entry>          m_entries;              // Cached chunks indexed by id
+                std::list<Chunk>                        m_freeChunks;           // Nodes of the chunks taken out of the cache (reused by the next chunks inserted)
+                std::vector<std::unordered_map<int, Entry>::node_type> m_freeEntries; // Nodes of the entries removed from the index (reused too)
+                size_t                                  m_budget;               // Maximum amount of memory used by the cached chunks (in bytes)
+                size_t                                  m_usedBytes;            // Memory currently used by the cached chunks (in bytes)
+                bool                                    m_compress;             // If true chunks are compressed while they are in the cache
+                bool                                    m_evictionPaused;       // If true no chunk is written to disk (the cache can exceed its budget)
+                uint64_t                                m_hits;
+                uint64_t                                m_misses;
+        };
+
+}
+
+#endif // CHUNK_CACHE_H
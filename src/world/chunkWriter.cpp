@@ -0,0 +1,206 @@
+
+#include "chunkWriter.hpp"
+#include "gameWorld.hpp"
+#include "worldLoader.hpp"
+#include "blockJournal.hpp"
+
+namespace mc2d {
+
+
+        // A chunk (or a batch of journal records) waiting to be written and the directory of its world
+        struct ChunkWriter::PendingWrite {
+                std::filesystem::path   worldDirPath;
+                Chunk                   chunk;
+                bool                    isJournal;              // If true the write is the journal batch, the chunk is empty
+                JournalBatch            journal;
+        };
+
+
+        ChunkWriter::ChunkWriter() : m_stopWorker(false), m_failed(false), m_journalFailed(false), m_writesNum(0), m_coalescedNum(0), m_stallsNum(0)
+        {}
+
+
+        // Writes all the queued chunks and stops the writer thread
+        ChunkWriter::~ChunkWriter()
+        {
+                flush();
+                stopWorker();
+        }
+
+
+        // Queues a chunk to be written in the directory of its world, if an older version of the chunk is still in the queue
+        // it gets replaced, if the queue is full waits until the writer thread makes room
+        // @worldDirPath: path to the directory that contains the world data
+        // @chunk: the chunk to save
+        void ChunkWriter::write(const std::filesystem::path& worldDirPath, Chunk&& chunk)
+        {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                for(PendingWrite& w : m_queue)
+                {
+                        if(!w.isJournal && w.chunk.id == chunk.id && w.worldDirPath == worldDirPath)
+                        {
+                                w.chunk = std::move(chunk);
+                                ++m_coalescedNum;
+                                return;
+                        }
+                }
+
+                enqueue(lock, { worldDirPath, std::move(chunk), false, {} });
+        }
+
+
+        // Queues a batch of records to be written in the block journal of a world (after the writes queued before it)
+        // @worldDirPath: path to the directory that contains the world data
+        // @batch: the records taken from the journal (see BlockJournal::takeNewRecords())
+        void ChunkWriter::writeJournal(const std::filesystem::path& worldDirPath, JournalBatch&& batch)
+        {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                enqueue(lock, { worldDirPath, Chunk(), true, std::move(batch) });
+        }
+
+
+        // Adds a write at the end of the queue (starting the writer thread if needed), if the queue is full waits until the
+        // writer thread makes room
+        // @lock: lock held on the mutex of the writer
+        // @write: the write to queue
+        void ChunkWriter::enqueue(std::unique_lock<std::mutex>& lock, PendingWrite&& write)
+        {
+                if(!m_worker.joinable())
+                {
+                        m_stopWorker = false;
+                        m_worker = std::thread(&ChunkWriter::workerLoop, this);
+                }
+
+                if(m_queue.size() >= MAX_PENDING_CHUNK_WRITES)
+                {
+                        ++m_stallsNum;
+                        m_writeDone.wait(lock, [this]() { return m_queue.size() < MAX_PENDING_CHUNK_WRITES; });
+                }
+
+                m_queue.push_back(std::move(write));
+                m_wakeWorker.notify_one();
+        }
+
+
+        // Takes back a chunk that is waiting to be written, if the chunk is being written waits until its file is complete
+        // @worldDirPath: path to the directory that contains the world data
+        // @id: id of the chunk
+        // @chunk: if the chunk is in the queue it is moved in here (decompressed)
+        // @returns: true if the chunk was in the queue, false otherwise (its file is up to date)
+        bool ChunkWriter::take(const std::filesystem::path& worldDirPath, int id, Chunk& chunk)
+        {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                for(auto w = m_queue.begin(); w != m_queue.end(); ++w)
+                {
+                        if(!w->isJournal && w->chunk.id == id && w->worldDirPath == worldDirPath)
+                        {
+                                chunk = std::move(w->chunk);
+                                m_queue.erase(w);
+                                m_writeDone.notify_all();
+
+                                lock.unlock();
+                                chunk.decompress();
+                                return true;
+                        }
+                }
+
+                m_writeDone.wait(lock, [this, &worldDirPath, id]() { return !isWriting(worldDirPath, id); });
+                return false;
+        }
+
+
+        // Waits until all the queued chunks (and journal batches) have been written
+        // @returns: true if all the writes since the last flush succeeded, false otherwise
+        bool ChunkWriter::flush()
+        {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_writeDone.wait(lock, [this]() { return m_queue.empty() && m_inFlight.empty(); });
+
+                bool res = !m_failed;
+                m_failed = false;
+                return res;
+        }
+
+
+        // Returns true if all the journal batches written since the last call have been written (if one failed the journal file
+        // can end with a record cut in half, the next batch must rewrite it)
+        bool ChunkWriter::checkJournalWrites()
+        {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                bool res = !m_journalFailed;
+                m_journalFailed = false;
+                return res;
+        }
+
+
+        // Returns the number of writes (chunks or journal batches) waiting to be done (or being done)
+        size_t ChunkWriter::getPendingNum() const
+        {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_queue.size() + m_inFlight.size();
+        }
+
+
+        // Returns the number of chunks written
+        uint64_t ChunkWriter::getWritesNum() const
+        {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_writesNum;
+        }
+
+
+        // Main loop of the writer thread, writes the queued chunks (in order) until the writer is stopped
+        void ChunkWriter::workerLoop()
+        {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while(true)
+                {
+                        m_wakeWorker.wait(lock, [this]() { return m_stopWorker || !m_queue.empty(); });
+                        if(m_queue.empty())
+                                return;
+
+                        m_inFlight.splice(m_inFlight.begin(), m_queue, m_queue.begin());
+                        m_writeDone.notify_all();                       // There is room in the queue now
+
+                        const PendingWrite& w = m_inFlight.front();
+                        lock.unlock();
+                        bool res = w.isJournal ? WorldLoader::appendJournal(w.worldDirPath, w.journal) : WorldLoader::saveChunk(w.worldDirPath, w.chunk);
+                        lock.lock();
+
+                        m_failed |= !res;
+                        if(w.isJournal)
+                                m_journalFailed |= !res;
+                        else
+                                ++m_writesNum;
+
+                        m_inFlight.clear();
+                        m_writeDone.notify_all();
+                }
+        }
+
+
+        // Stops the writer thread (after it has written the queued chunks)
+        void ChunkWriter::stopWorker()
+        {
+                if(!m_worker.joinable())
+                        return;
+
+                {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stopWorker = true;
+                }
+
+                m_wakeWorker.notify_all();
+                m_worker.join();
+        }
+
+
+        // Returns true if the writer thread is writing the given chunk (must be called with the mutex locked)
+        bool ChunkWriter::isWriting(const std::filesystem::path& worldDirPath, int id) const
+        {
+                return !m_inFlight.empty() && !m_inFlight.front().isJournal && m_inFlight.front().chunk.id == id && m_inFlight.front().worldDirPath == worldDirPath;
+        }
+
+}
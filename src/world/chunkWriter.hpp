@@ -0,0 +1,86 @@
+
+// Contains definition of the ChunkWriter class, this class writes chunk files on a background thread so that saving a
+// chunk never stops the simulation (write-behind).
+//
+// Chunks to save are moved in a queue that is emptied by the writer thread in order. If a chunk is queued again before
+// its previous version has been written the two writes are coalesced (only the newest version is kept). The queue holds
+// at most MAX_PENDING_CHUNK_WRITES chunks, when it is full write() waits for the writer thread (backpressure). A chunk
+// that is still in the queue can be taken back (so that it is not loaded from an old file), flush() waits until all
+// the queued chunks have been written (it must be called before the world directory is used by someone else, on exit
+// and when the scene changes).
+// The writer also writes the block journal (see BlockJournal): the autosave queues the new records in a JournalBatch, the
+// writer thread appends them to the journal file and syncs it (or rewrites the file), so the simulation thread never
+// waits for the disk. Journal writes keep their place in the queue: a compaction queued after some chunks rewrites the
+// journal only once those chunks are on disk.
+// The writer thread is started the first time it is needed. A writer cannot be copied (nor moved), its thread works on it.
+//
+
+#ifndef CHUNK_WRITER_H
+#define CHUNK_WRITER_H
+
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+        struct Chunk;
+        struct JournalBatch;
+
+
+        constexpr size_t MAX_PENDING_CHUNK_WRITES = 64;         // Maximum number of chunks waiting to be written
+
+
+        class ChunkWriter {
+        public:
+                ChunkWriter();
+                ~ChunkWriter();
+
+                // Delete copy constructors
+                ChunkWriter(const ChunkWriter& other) = delete;
+                ChunkWriter&            operator = (const ChunkWriter& other) = delete;
+
+                void                    write(const std::filesystem::path& worldDirPath, Chunk&& chunk);
+                void                    writeJournal(const std::filesystem::path& worldDirPath, JournalBatch&& batch);
+                bool                    take(const std::filesystem::path& worldDirPath, int id, Chunk& chunk);
+                bool                    flush();
+                bool                    checkJournalWrites();
+
+                size_t                  getPendingNum() const;
+                uint64_t                getWritesNum() const;
+                inline uint64_t         getCoalescedNum() const                 { return m_coalescedNum; }
+                inline uint64_t         getStallsNum() const                    { return m_stallsNum; }
+
+        private:
+
+                struct PendingWrite;
+
+                void                    enqueue(std::unique_lock<std::mutex>& lock, PendingWrite&& write);
+                void                    workerLoop();
+                void                    stopWorker();
+                bool                    isWriting(const std::filesystem::path& worldDirPath, int id) const;
+
+                std::thread             m_worker;
+                mutable std::mutex      m_mutex;
+                std::condition_variable m_wakeWorker;           // Signaled when a chunk is queued (or the worker must stop)
+                std::condition_variable m_writeDone;            // Signaled when the worker has taken or written a chunk
+
+                std::list<PendingWrite> m_queue;                // Chunks waiting to be written (in order)
+                std::list<PendingWrite> m_inFlight;             // Chunk that the worker is writing (if any)
+                bool                    m_stopWorker;
+                bool                    m_failed;               // True if a write has failed since the last flush
+                bool                    m_journalFailed;        // True if a journal write has failed since the last checkJournalWrites()
+
+                uint64_t                m_writesNum;            // Chunks written
+                uint64_t                m_coalescedNum;         // Writes merged with a write of the same chunk that was still queued
+                uint64_t                m_stallsNum;            // Times write() had to wait because the queue was full
+        };
+
+}
+
+#endif // CHUNK_WRITER_H
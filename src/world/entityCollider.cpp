@@ -0,0 +1,330 @@
+
+#include "entityCollider.hpp"
+#include "gameWorld.hpp"
+#include "worldEncyclopedia.hpp"
+
+namespace mc2d {
+
+
+        // Small distance used to keep the edges of the collision boxes that lay on the border between two blocks inside of the first block
+        static constexpr float EDGE_EPSILON = 1e-3f;
+
+
+        // Moves all the entities of the world (applying gravity) and resolves their collisions with the blocks
+        // @world: the world that contains the entities
+        // @deltaTime: time passed from the last update (measured in milliseconds)
+        void EntityCollider::update(GameWorld& world, float deltaTime)
+        {
+                EntityStore& entities = world.m_entities;
+
+                for(size_t type = 0; type < ENTITY_TYPES_NUM; ++type)
+                {
+                        EntityArchetype& a = entities.getArchetype(static_cast<EntityType>(type));
+                        if(WorldEncyclopedia::getEntityProperties(static_cast<EntityType>(type)).gravity)
+                        {
+                                for(size_t i = 0; i < a.size(); ++i)
+                                        a.accY[i] -= ENTITY_GRAVITY;
+                        }
+                }
+
+                entities.update(deltaTime);
+
+                ChunkLookup chunks = { world };
+                for(EntityHandle p : world.m_players)
+                {
+                        const EntityType type = entities.getType(p);
+                        resolveEntity(chunks, entities.getArchetype(type), entities.getIndex(p), WorldEncyclopedia::getEntityProperties(type));
+                }
+
+                // The entities of the ticking chunks are resolved with the checkerboard schedule
+                for(int phase = 0; phase < 2; ++phase)
+                {
+                        m_phaseChunks[phase].clear();
+                        m_phaseEntitiesNum[phase].clear();
+                }
+
+                for(auto& c : world.m_loadedChunks)
+                {
+                        if(c.second.tier == ChunkTier::TICKING && !c.second.entityHandles.empty())
+                        {
+                                m_phaseChunks[c.first & 1].push_back(&(c.second));
+                                m_phaseEntitiesNum[c.first & 1].push_back(c.second.entityHandles.size());
+                        }
+                }
+
+                for(int phase = 0; phase < 2; ++phase)
+                {
+                        const std::vector<Chunk*>& phaseChunks = m_phaseChunks[phase];
+                        const std::vector<size_t>& phaseEntitiesNum = m_phaseEntitiesNum[phase];
+                        if(m_outboxes.size() < phaseChunks.size())
+                                m_outboxes.resize(phaseChunks.size());
+
+                        auto resolve = [&](size_t i) {
+                                m_outboxes[i].clear();
+                                resolveChunk(world, *phaseChunks[i], phaseEntitiesNum[i], m_outboxes[i]);
+                        };
+
+                        size_t entitiesNum = 0;
+                        for(size_t n : phaseEntitiesNum)
+                                entitiesNum += n;
+
+                        if(phaseChunks.size() < 2 || entitiesNum < MIN_PARALLEL_COLLISION_ENTITIES)
+                        {
+                                for(size_t i = 0; i < phaseChunks.size(); ++i)
+                                        resolve(i);
+                        } else {
+                                world.m_taskPool.run(phaseChunks.size(), resolve);
+                        }
+
+                        // The entities that crossed a border enter their new chunks (in the order of the chunks of the phase)
+                        world.m_entityMigrations.clear();
+                        for(size_t i = 0; i < phaseChunks.size(); ++i)
+                                world.m_entityMigrations.insert(world.m_entityMigrations.end(), m_outboxes[i].begin(), m_outboxes[i].end());
+
+                        world.applyEntityMigrations();
+                }
+        }
+
+
+        // Resolves the collisions of the entities of one chunk, it writes only the entities of the chunk (so it can be called
+        // concurrently on other chunks), the entities that leave the chunk are removed from it and written in the outbox
+        // @world: the world that contains the chunk
+        // @chunk: the chunk (ticking)
+        // @entitiesNum: number of entities that the chunk had at the beginning of the update (the ones after them arrived
+        //               from another chunk in this update, so they have already been resolved)
+        // @outbox: vector in which the entities that leave the chunk are appended (with the id of their new chunk)
+        void EntityCollider::resolveChunk(GameWorld& world, Chunk& chunk, size_t entitiesNum, std::vector<std::pair<int, EntityHandle>>& outbox)
+        {
+                EntityStore& entities = world.m_entities;
+                std::vector<EntityHandle>& handles = chunk.entityHandles;
+                ChunkLookup chunks = { world };
+
+                // The entities that stay are compacted at the beginning (the handles of the destroyed entities are dropped)
+                size_t keptNum = 0;
+                for(size_t i = 0; i < entitiesNum; ++i)
+                {
+                        const EntityHandle h = handles[i];
+                        if(!entities.isValid(h))
+                                continue;
+
+                        const EntityType type = entities.getType(h);
+                        EntityArchetype& a = entities.getArchetype(type);
+                        const size_t index = entities.getIndex(h);
+                        resolveEntity(chunks, a, index, WorldEncyclopedia::getEntityProperties(type));
+
+                        const int chunkId = (int) std::floor(a.posX[index] / (float) Chunk::width);
+                        if(chunkId == chunk.id)
+                                handles[keptNum++] = h;
+                        else
+                                outbox.push_back( { chunkId, h } );
+                }
+
+                handles.erase(handles.begin() + keptNum, handles.begin() + entitiesNum);
+        }
+
+
+        // Moves back an entity that went through a collidable block
+        // @chunks: used to look up the chunks that contain the blocks
+        // @a: the archetype that contains the entity (already integrated)
+        // @i: index of the entity in the archetype
+        // @props: properties of the entity type of the archetype
+        void EntityCollider::resolveEntity(ChunkLookup& chunks, EntityArchetype& a, size_t i, const EntityProperties& props)
+        {
+                float x = a.prevPosX[i];
+                float y = a.prevPosY[i];
+                float dx = a.posX[i] - x;
+                float dy = a.posY[i] - y;
+
+                if(sweepX(chunks, x, y, dx, props.width, props.height, x))
+                        a.velX[i] = 0.0f;
+                else
+                        x = a.posX[i];
+
+                bool hitY = sweepY(chunks, x, y, dy, props.width, props.height, y);
+                if(hitY)
+                        a.velY[i] = 0.0f;
+                else
+                        y = a.posY[i];
+
+                a.posX[i] = x;
+                a.posY[i] = y;
+                a.grounded[i] = hitY && dy < 0.0f;
+        }
+
+
+        // Moves a collision box along the x axis until it hits a collidable block
+        // @chunks: used to look up the chunks that contain the blocks
+        // @x, @y: position of the bottom left corner of the box
+        // @dx: distance that the box must travel
+        // @width, @height: size of the box
+        // @newX: if a block is hit the x coordinate at which the box stops is written in it
+        // @returns: true if the box hits a block, false otherwise
+        bool EntityCollider::sweepX(ChunkLookup& chunks, float x, float y, float dx, float width, float height, float& newX)
+        {
+                if(dx == 0.0f)
+                        return false;
+
+                const int minY = (int) std::floor(y);
+                const int maxY = (int) std::floor(y + height - EDGE_EPSILON);
+
+                if(dx > 0.0f)
+                {
+                        // Columns reached by the right edge of the box, checked from left to right
+                        int first = (int) std::floor(x + width - EDGE_EPSILON) + 1;
+                        int last = (int) std::floor(x + dx + width - EDGE_EPSILON);
+
+                        for(int column = first; column <= last; )
+                        {
+                                int chunkId = Chunk::getIdFromBlockX(column);
+                                int chunkX = chunkId * Chunk::width;
+                                int end = std::min(last, chunkX + Chunk::width - 1);
+
+                                uint32_t blocked = getBlockedColumns(chunks, chunkId, minY, maxY) & getRangeMask(column - chunkX, end - chunkX);
+                                if(blocked != 0)
+                                {
+                                        newX = (float) (chunkX + __builtin_ctz(blocked)) - width;
+                                        return true;
+                                }
+
+                                column = end + 1;
+                        }
+
+                } else {
+                        // Columns reached by the left edge of the box, checked from right to left
+                        int first = (int) std::floor(x) - 1;
+                        int last = (int) std::floor(x + dx);
+
+                        for(int column = first; column >= last; )
+                        {
+                                int chunkId = Chunk::getIdFromBlockX(column);
+                                int chunkX = chunkId * Chunk::width;
+                                int end = std::max(last, chunkX);
+
+                                uint32_t blocked = getBlockedColumns(chunks, chunkId, minY, maxY) & getRangeMask(end - chunkX, column - chunkX);
+                                if(blocked != 0)
+                                {
+                                        newX = (float) (chunkX + 31 - __builtin_clz(blocked) + 1);
+                                        return true;
+                                }
+
+                                column = end - 1;
+                        }
+                }
+
+                return false;
+        }
+
+
+        // Moves a collision box along the y axis until it hits a collidable block
+        // @chunks: used to look up the chunks that contain the blocks
+        // @x, @y: position of the bottom left corner of the box
+        // @dy: distance that the box must travel
+        // @width, @height: size of the box
+        // @newY: if a block is hit the y coordinate at which the box stops is written in it
+        // @returns: true if the box hits a block, false otherwise
+        bool EntityCollider::sweepY(ChunkLookup& chunks, float x, float y, float dy, float width, float height, float& newY)
+        {
+                if(dy == 0.0f)
+                        return false;
+
+                const int minX = (int) std::floor(x);
+                const int maxX = (int) std::floor(x + width - EDGE_EPSILON);
+
+                if(dy > 0.0f)
+                {
+                        // Rows reached by the top edge of the box, checked from the bottom to the top
+                        int last = (int) std::floor(y + dy + height - EDGE_EPSILON);
+                        for(int row = (int) std::floor(y + height - EDGE_EPSILON) + 1; row <= last; ++row)
+                        {
+                                if(isRowBlocked(chunks, row, minX, maxX))
+                                {
+                                        newY = (float) row - height;
+                                        return true;
+                                }
+                        }
+
+                } else {
+                        // Rows reached by the bottom edge of the box, checked from the top to the bottom
+                        int last = (int) std::floor(y + dy);
+                        for(int row = (int) std::floor(y) - 1; row >= last; --row)
+                        {
+                                if(isRowBlocked(chunks, row, minX, maxX))
+                                {
+                                        newY = (float) (row + 1);
+                                        return true;
+                                }
+                        }
+                }
+
+                return false;
+        }
+
+
+        // Returns the mask of the columns of a chunk that contain at least one collidable block between the given rows
+        // @chunks: used to look up the chunk
+        // @chunkId: id of the chunk
+        // @minY, @maxY: range of rows to check (included)
+        // @returns: bit i is set if the column i of the chunk is blocked, all the bits are set if the chunk is not loaded
+        uint32_t EntityCollider::getBlockedColumns(ChunkLookup& chunks, int chunkId, int minY, int maxY)
+        {
+                const Chunk* c = getChunk(chunks, chunkId);
+                if(c == nullptr || minY < 0)
+                        return ~0u;
+
+                uint32_t blocked = 0;
+                for(int y = minY; y <= maxY && y < (int) Chunk::height; ++y)
+                        blocked |= c->collidableRows[y];
+
+                return blocked;
+        }
+
+
+        // Checks if there is at least one collidable block in a row between the given columns
+        // @chunks: used to look up the chunks that contain the blocks
+        // @y: y coordinate of the row
+        // @minX, @maxX: range of columns to check (included, in world space)
+        // @returns: true if there is a collidable block (rows below the world and chunks not loaded are always blocked), false otherwise
+        bool EntityCollider::isRowBlocked(ChunkLookup& chunks, int y, int minX, int maxX)
+        {
+                if(y < 0)
+                        return true;
+
+                if(y >= (int) Chunk::height)
+                        return false;
+
+                for(int column = minX; column <= maxX; )
+                {
+                        int chunkId = Chunk::getIdFromBlockX(column);
+                        int chunkX = chunkId * Chunk::width;
+                        int end = std::min(maxX, chunkX + Chunk::width - 1);
+
+                        const Chunk* c = getChunk(chunks, chunkId);
+                        if(c == nullptr || (c->collidableRows[y] & getRangeMask(column - chunkX, end - chunkX)) != 0)
+                                return true;
+
+                        column = end + 1;
+                }
+
+                return false;
+        }
+
+
+        // Returns the loaded chunk with the given id
+        // @chunks: the lookup of the calling thread
+        // @chunkId: id of the chunk
+        // @returns: a pointer to the chunk, nullptr if the chunk is not loaded
+        const Chunk* EntityCollider::getChunk(ChunkLookup& chunks, int chunkId)
+        {
+                if(chunks.cachedChunk != nullptr && chunks.cachedChunkId == chunkId)
+                        return chunks.cachedChunk;
+
+                auto c = chunks.world.m_loadedChunks.find(chunkId);
+                if(c == chunks.world.m_loadedChunks.end())
+                        return nullptr;
+
+                chunks.cachedChunkId = chunkId;
+                chunks.cachedChunk = &(c->second);
+                return chunks.cachedChunk;
+        }
+
+}
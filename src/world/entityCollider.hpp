@@ -0,0 +1,81 @@
+
+// Contains definition of the EntityCollider class, this class moves the entities of the world and keeps them out of the
+// collidable blocks.
+//
+// Each update the entities are integrated by the entity store (with the gravity added to their acceleration), then their
+// motion (from the previous position kept by the store) is resolved against the blocks one axis at a time (first x then y): the collision box of the entity is swept along
+// the axis and only the columns (or rows) of blocks that its leading edge goes through are checked. The blocks are read from
+// the masks of collidable blocks kept by the chunks, a whole column range of a row is checked with a single AND and the
+// first blocking block is found with a bit scan.
+// Entities stop at the first collidable block that they hit (and lose their velocity on that axis), an entity that hits a
+// block while falling is grounded. Chunks that are not loaded and the space below the world are treated as solid.
+//
+// The collisions of the entities of the ticking chunks are resolved in parallel with the same checkerboard schedule of the
+// random ticks (see RandomTicker): the chunks with an even id in a first phase and the ones with an odd id in a second one.
+// Resolving the collisions of a chunk only reads the blocks and writes its own entities, an entity that crosses the border
+// of its chunk is removed from it and written in the outbox of the chunk, the outboxes of a phase are applied at its end
+// (in the order of the chunks, see GameWorld::applyEntityMigrations()). The entities that reach a chunk of the second phase
+// from the first one are not moved twice, each chunk only resolves the entities that it had at the beginning of the update.
+// Players are not owned by a chunk, their collisions are resolved on the calling thread. The motion of each entity only
+// depends on the blocks, so the result never depends on the number of threads.
+//
+
+#ifndef ENTITY_COLLIDER_H
+#define ENTITY_COLLIDER_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "log.hpp"
+#include "entityStore.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+        struct Chunk;
+        struct EntityProperties;
+
+
+        constexpr float ENTITY_GRAVITY = 40.0f;                 // Acceleration applied to the entities affected by gravity (measured in blocks/second^2)
+        constexpr float PLAYER_JUMP_VELOCITY = 20.0f;           // Vertical velocity given to a grounded player when it jumps (measured in blocks/second)
+        constexpr size_t MIN_PARALLEL_COLLISION_ENTITIES = 128; // Phases with fewer entities than this (or with one chunk) are resolved on the calling thread
+
+
+        class EntityCollider {
+        public:
+                EntityCollider() = default;
+                ~EntityCollider() = default;
+
+                void                    update(GameWorld& world, float deltaTime);
+
+        private:
+
+                // Looks up the loaded chunks for one thread, the last chunk found is cached (entities often query the same
+                // chunk many times)
+                struct ChunkLookup {
+                        const GameWorld&        world;
+                        int                     cachedChunkId = 0;
+                        const Chunk*            cachedChunk = nullptr;
+                };
+
+                void                    resolveChunk(GameWorld& world, Chunk& chunk, size_t entitiesNum, std::vector<std::pair<int, EntityHandle>>& outbox);
+                static void             resolveEntity(ChunkLookup& chunks, EntityArchetype& a, size_t i, const EntityProperties& props);
+                static bool             sweepX(ChunkLookup& chunks, float x, float y, float dx, float width, float height, float& newX);
+                static bool             sweepY(ChunkLookup& chunks, float x, float y, float dy, float width, float height, float& newY);
+
+                static uint32_t         getBlockedColumns(ChunkLookup& chunks, int chunkId, int minY, int maxY);
+                static bool             isRowBlocked(ChunkLookup& chunks, int y, int minX, int maxX);
+                static const Chunk*     getChunk(ChunkLookup& chunks, int chunkId);
+
+                // Returns a mask in which the bits from first to last (included) are set
+                static inline uint32_t  getRangeMask(int first, int last)       { return (last - first >= 31 ? ~0u : (1u << (last - first + 1)) - 1) << first; }
+
+                std::vector<Chunk*>     m_phaseChunks[2];       // Ticking chunks with entities (one vector for the even and one for the odd chunks)
+                std::vector<size_t>     m_phaseEntitiesNum[2];  // Number of entities of each chunk at the beginning of the update
+                std::vector<std::vector<std::pair<int, EntityHandle>>> m_outboxes; // Entities that left each chunk of the current phase (with the id of the new chunk)
+        };
+
+}
+
+#endif // ENTITY_COLLIDER_H
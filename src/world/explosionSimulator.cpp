@@ -0,0 +1,158 @@
+
+#include "explosionSimulator.hpp"
+#include "gameWorld.hpp"
+#include "worldEncyclopedia.hpp"
+
+#if defined(__SSE2__)
+        #include <emmintrin.h>
+#endif
+
+namespace mc2d {
+
+
+        // Square of the distance at which the intensity of the blast goes to zero (just outside of the blast radius)
+        static constexpr float BLAST_FALLOFF_DISTANCE_SQUARED = (TNT_BLAST_RADIUS + 0.5f) * (TNT_BLAST_RADIUS + 0.5f);
+
+
+        ExplosionSimulator::ExplosionSimulator() : m_explosionsBudget(DEFAULT_EXPLOSIONS_BUDGET)
+        {}
+
+
+        // Executes the queued explosions (up to the explosions budget) and removes all the destroyed blocks
+        // @world: the world in which the explosions happen
+        void ExplosionSimulator::tick(GameWorld& world)
+        {
+                if(m_queue.empty())
+                        return;
+
+                for(size_t i = 0; i < m_explosionsBudget && !m_queue.empty(); ++i)
+                {
+                        uint64_t pos = m_queue.front();
+                        m_queue.pop_front();
+                        m_queuedPositions.erase(pos);
+
+                        explode(world, unpackX(pos), unpackY(pos));
+                }
+
+                for(auto& edits : m_chunkEdits)
+                {
+                        if(!edits.second.empty())
+                                world.applyBlockEdits(edits.second);
+
+                        edits.second.clear();           // Keep the vectors so that their memory can be reused
+                }
+        }
+
+
+        // Adds the TNT block at the given position to the blocks that will explode in the next ticks
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        void ExplosionSimulator::queueExplosion(int x, int y)
+        {
+                uint64_t pos = packPos(x, y);
+                if(m_queuedPositions.insert(pos).second)
+                        m_queue.push_back(pos);
+        }
+
+
+        // Makes the TNT block at the given position explode, destroyed blocks are added to the edits of their chunk
+        // and the TNT blocks hit by the blast are ignited
+        // @world: the world that contains the TNT block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        void ExplosionSimulator::explode(GameWorld& world, int x, int y)
+        {
+                Chunk* c = world.findChunk(x, y);
+                if(c == nullptr || c->blocks[c->getBlockIndex(x, y)] != BlockType::TNT)
+                        return;
+
+                m_chunkEdits[c->id].push_back( { x, y, BlockType::AIR } );
+
+                float hardness[BLAST_ROW_SIZE];
+                BlockType blocks[BLAST_ROW_SIZE];
+                uint8_t destroyed[BLAST_ROW_SIZE];
+
+                for(int distanceY = -TNT_BLAST_RADIUS; distanceY <= TNT_BLAST_RADIUS; ++distanceY)
+                {
+                        int rowY = y + distanceY;
+                        if(rowY < 0 || rowY >= (int) Chunk::height)
+                                continue;
+
+                        // Gather the hardness of the blocks in the row, blocks that cannot be destroyed (air, fluids, TNT, blocks
+                        // outside of the loaded chunks and the padding at the end of the row) are given an infinite hardness
+                        for(int i = 0; i < BLAST_ROW_SIZE; ++i)
+                        {
+                                int blockX = x - TNT_BLAST_RADIUS + i;
+                                Chunk* rowChunk = i <= 2 * TNT_BLAST_RADIUS ? world.findChunk(blockX, rowY) : nullptr;
+
+                                blocks[i] = rowChunk != nullptr ? rowChunk->blocks[rowChunk->getBlockIndex(blockX, rowY)] : BlockType::AIR;
+                                hardness[i] = blocks[i] == BlockType::AIR || blocks[i] == BlockType::TNT || FluidSimulator::isFluid(blocks[i]) ?
+                                        INFINITY : (float) WorldEncyclopedia::getBlockProperties(blocks[i]).hardness;
+                        }
+
+                        evaluateBlastRow(hardness, distanceY, destroyed);
+
+                        for(int i = 0; i <= 2 * TNT_BLAST_RADIUS; ++i)
+                        {
+                                int blockX = x - TNT_BLAST_RADIUS + i;
+                                int distanceX = i - TNT_BLAST_RADIUS;
+
+                                if(destroyed[i])
+                                {
+                                        m_chunkEdits[Chunk::getIdFromBlockX(blockX)].push_back( { blockX, rowY, BlockType::AIR } );
+
+                                } else if(blocks[i] == BlockType::TNT && (distanceX != 0 || distanceY != 0) &&
+                                        distanceX * distanceX + distanceY * distanceY <= TNT_BLAST_RADIUS * TNT_BLAST_RADIUS) {
+
+                                        // Other TNT blocks get a short fuse, so chain reactions spread over the next ticks
+                                        if(!world.isTickScheduled(blockX, rowY) && m_queuedPositions.count(packPos(blockX, rowY)) == 0)
+                                        {
+                                                std::uniform_int_distribution<uint64_t> fuseDistrib(TNT_CHAIN_MIN_FUSE_TICKS, TNT_CHAIN_MAX_FUSE_TICKS);
+                                                world.scheduleTick(blockX, rowY, BlockType::TNT, fuseDistrib(world.m_rng));
+                                        }
+                                }
+                        }
+                }
+        }
+
+
+        // Determines which blocks of one row of the blast are destroyed, the intensity of the blast at a distance d
+        // from the center is TNT_BLAST_POWER * (1 - d^2 / BLAST_FALLOFF_DISTANCE_SQUARED)
+        // @hardness: hardness of the blocks in the row (BLAST_ROW_SIZE elements, the first one is at TNT_BLAST_RADIUS blocks to the left of the center)
+        // @distanceY: vertical distance between the row and the center of the blast
+        // @destroyed: for each block of the row 1 will be written in it if the block is destroyed, 0 otherwise
+        void ExplosionSimulator::evaluateBlastRow(const float* hardness, int distanceY, uint8_t* destroyed)
+        {
+#if defined(__SSE2__)
+                const __m128 power = _mm_set1_ps(TNT_BLAST_POWER);
+                const __m128 falloff = _mm_set1_ps(TNT_BLAST_POWER / BLAST_FALLOFF_DISTANCE_SQUARED);
+                const __m128 distanceYSquared = _mm_set1_ps((float) (distanceY * distanceY));
+                const __m128 step = _mm_set1_ps(4.0f);
+
+                __m128 distanceX = _mm_setr_ps(-TNT_BLAST_RADIUS, -TNT_BLAST_RADIUS + 1, -TNT_BLAST_RADIUS + 2, -TNT_BLAST_RADIUS + 3);
+                for(int i = 0; i < BLAST_ROW_SIZE; i += 4)
+                {
+                        __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(distanceX, distanceX), distanceYSquared);
+                        __m128 intensity = _mm_sub_ps(power, _mm_mul_ps(distanceSquared, falloff));
+                        int mask = _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(hardness + i), intensity));
+
+                        destroyed[i] = mask & 1;
+                        destroyed[i + 1] = (mask >> 1) & 1;
+                        destroyed[i + 2] = (mask >> 2) & 1;
+                        destroyed[i + 3] = (mask >> 3) & 1;
+
+                        distanceX = _mm_add_ps(distanceX, step);
+                }
+#else
+                for(int i = 0; i < BLAST_ROW_SIZE; ++i)
+                {
+                        float distanceX = (float) (i - TNT_BLAST_RADIUS);
+                        float distanceSquared = distanceX * distanceX + (float) (distanceY * distanceY);
+                        float intensity = TNT_BLAST_POWER - distanceSquared * (TNT_BLAST_POWER / BLAST_FALLOFF_DISTANCE_SQUARED);
+
+                        destroyed[i] = hardness[i] < intensity ? 1 : 0;
+                }
+#endif
+        }
+
+}
@@ -0,0 +1,70 @@
+
+// Contains definition of the ExplosionSimulator class, this class makes the TNT blocks explode.
+//
+// An explosion destroys the blocks in a disc around the TNT block, the intensity of the blast decreases with the
+// distance from the center and a block is destroyed only if its hardness is lower than the intensity that reaches it.
+// The blast is evaluated one row of the disc at a time, the intensity of all the blocks in a row is computed in parallel
+// (with SSE2 when available).
+//
+// Explosions are not executed immediately: TNT blocks whose fuse has burned out are queued and only a limited number of
+// them explodes in each tick, the TNT blocks hit by an explosion are ignited (through the tick scheduler) instead of exploding
+// recursively. All the blocks destroyed in one tick are removed with one batched edit per chunk.
+//
+
+#ifndef EXPLOSION_SIMULATOR_H
+#define EXPLOSION_SIMULATOR_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_set>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+
+
+        constexpr int TNT_BLAST_RADIUS = 4;                             // Radius (measured in blocks) of the disc affected by an explosion
+        constexpr float TNT_BLAST_POWER = 6.0f;                         // Intensity of the blast at its center, it goes down to zero just outside the blast radius
+        constexpr uint64_t TNT_CHAIN_MIN_FUSE_TICKS = 10;               // Fuse (min and max) of the TNT blocks ignited by an explosion
+        constexpr uint64_t TNT_CHAIN_MAX_FUSE_TICKS = 30;
+        constexpr size_t DEFAULT_EXPLOSIONS_BUDGET = 8;                 // Default maximum number of explosions executed in one tick
+
+
+        class ExplosionSimulator {
+        public:
+                ExplosionSimulator();
+                ~ExplosionSimulator() = default;
+
+                void                    tick(GameWorld& world);
+                void                    queueExplosion(int x, int y);
+
+                inline void             setExplosionsBudget(size_t budget)      { m_explosionsBudget = budget > 0 ? budget : 1; }
+                inline size_t           getExplosionsBudget() const             { return m_explosionsBudget; }
+                inline size_t           getQueuedExplosionsNum() const          { return m_queue.size(); }
+
+        private:
+
+                // Number of blocks in one row of the blast, rounded up to a multiple of 4 so that rows can be processed 4 blocks at a time
+                static constexpr int    BLAST_ROW_SIZE = ((2 * TNT_BLAST_RADIUS + 1 + 3) / 4) * 4;
+
+                void                    explode(GameWorld& world, int x, int y);
+                static void             evaluateBlastRow(const float* hardness, int distanceY, uint8_t* destroyed);
+
+                static inline uint64_t  packPos(int x, int y)                   { return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y; }
+                static inline int       unpackX(uint64_t pos)                   { return (int) (uint32_t) (pos >> 32); }
+                static inline int       unpackY(uint64_t pos)                   { return (int) (uint32_t) pos; }
+
+                size_t                                  m_explosionsBudget;     // Maximum number of explosions executed in one tick
+                std::deque<uint64_t>                    m_queue;                // TNT blocks that are waiting to explode
+                std::unordered_set<uint64_t>            m_queuedPositions;      // Same blocks of the queue, used to avoid duplicates
+                std::map<int, std::vector<BlockEdit>>   m_chunkEdits;           // Blocks destroyed in the current tick, grouped by chunk
+        };
+
+}
+
+#endif // EXPLOSION_SIMULATOR_H
@@ -0,0 +1,387 @@
+
+#include "fluidSimulator.hpp"
+#include "gameWorld.hpp"
+
+#include <cassert>
+
+namespace mc2d {
+
+
+        FluidSimulator::FluidSimulator() : m_cellsBudget(DEFAULT_FLUID_CELLS_BUDGET)
+        {}
+
+
+        // Advances the fluid simulation by one tick, only the active cells are processed (up to the cells budget)
+        // @world: the world in which fluids must be simulated
+        // @currTick: number of the current world tick
+        void FluidSimulator::tick(GameWorld& world, uint64_t currTick)
+        {
+                const bool isLavaTick = currTick % LAVA_FLOW_INTERVAL == 0;
+                size_t processedCells = 0;
+
+                // Step 1] Compute the flows of the active cells using the current state of the world (lava only in its flow ticks)
+                if(isLavaTick)
+                        processQueue(world, m_lavaQueue, isLavaTick, processedCells);
+
+                processQueue(world, m_activeQueue, isLavaTick, processedCells);
+
+                // Step 2] Apply all the flows together
+                applyChanges(world);
+        }
+
+
+        // Computes the flows of the cells in the given queue (until the cells budget is reached), the cells of the chunks that
+        // are not ticking are parked and the lava cells are moved in the lava queue if this is not a lava flow tick
+        // @world: the world in which fluids must be simulated
+        // @queue: the queue of cells to process
+        // @isLavaTick: true if lava flows in this tick
+        // @processedCells: number of cells processed in this tick (updated)
+        void FluidSimulator::processQueue(GameWorld& world, std::deque<uint64_t>& queue, bool isLavaTick, size_t& processedCells)
+        {
+                const size_t cellsNum = queue.size();
+                for(size_t i = 0; i < cellsNum && processedCells < m_cellsBudget; ++i)
+                {
+                        uint64_t pos = queue.front();
+                        queue.pop_front();
+
+                        int x = unpackX(pos);
+                        int y = unpackY(pos);
+
+                        // Cells in frozen chunks wait until their chunk ticks again (see onChunkTierChanged())
+                        const Chunk* c = world.peekChunk(x, y);
+                        if(c != nullptr && c->tier != ChunkTier::TICKING)
+                        {
+                                m_parkedCells[c->id].push_back(pos);
+                                continue;
+                        }
+
+                        // Lava is slower than water, it waits until its next flow tick
+                        if(!isLavaTick && getBlock(world, x, y) == BlockType::LAVA)
+                        {
+                                m_lavaQueue.push_back(pos);
+                                continue;
+                        }
+
+                        m_activeCells.erase(pos);
+                        computeFlow(world, x, y);
+                        ++processedCells;
+                }
+        }
+
+
+        // Initializes the fluid levels of a chunk that has just been loaded and activates all its fluid cells
+        // @chunk: the loaded chunk
+        void FluidSimulator::onChunkLoaded(Chunk& chunk)
+        {
+                // Chunks that have just been generated (or saved without fluid data) contain only full fluid blocks
+                if(chunk.fluidLevels.size() != chunk.blocks.size())
+                {
+                        if(chunk.fluidLevels.capacity() == 0)
+                                chunk.fluidLevels = ChunkBufferPool::acquireLevels();
+
+                        chunk.fluidLevels.resize(chunk.blocks.size());
+                        for(size_t i = 0; i < chunk.blocks.size(); ++i)
+                                chunk.fluidLevels[i] = isFluid(chunk.blocks[i]) ? MAX_FLUID_LEVEL : 0;
+                }
+
+                int firstX = chunk.id * Chunk::width;
+                for(int x = firstX; x < firstX + Chunk::width; ++x)
+                {
+                        for(int y = 0; y < Chunk::height; ++y)
+                        {
+                                if(isFluid(chunk.blocks[chunk.getBlockIndex(x, y)]))
+                                        activateCell(x, y);
+                        }
+                }
+        }
+
+
+        // Notifies the simulator that the tier of a chunk has changed, the cells parked with the chunk are queued again when
+        // it ticks and dropped when it gets unloaded (they are activated again when the chunk is loaded)
+        // @chunk: the chunk
+        void FluidSimulator::onChunkTierChanged(const Chunk& chunk)
+        {
+                if(chunk.tier == ChunkTier::FROZEN)
+                        return;
+
+                auto parked = m_parkedCells.find(chunk.id);
+                if(parked == m_parkedCells.end())
+                        return;
+
+                for(uint64_t pos : parked->second)
+                {
+                        if(chunk.tier == ChunkTier::TICKING)
+                                m_activeQueue.push_back(pos);
+                        else
+                                m_activeCells.erase(pos);
+                }
+
+                m_parkedCells.erase(parked);
+        }
+
+
+        // Notifies the simulator that the block at the given position has changed, the block
+        // and its neighbors will be processed in the next tick
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        void FluidSimulator::onBlockChanged(int x, int y)
+        {
+                activateCell(x, y);
+                activateCell(x - 1, y);
+                activateCell(x + 1, y);
+                activateCell(x, y - 1);
+                activateCell(x, y + 1);
+        }
+
+
+        // Computes the amount of fluid that flows out of the given cell and writes it in the back buffer
+        // @world: the world that contains the cell
+        // @x: x coordinate of the cell in world space
+        // @y: y coordinate of the cell in world space
+        void FluidSimulator::computeFlow(GameWorld& world, int x, int y)
+        {
+                uint8_t level = 0;
+                BlockType fluid = getBlock(world, x, y, &level);
+                if(!isFluid(fluid) || level == 0)
+                        return;
+
+                // Lava that touches water solidifies
+                if(fluid == BlockType::LAVA)
+                {
+                        if(getBlock(world, x - 1, y) == BlockType::WATER || getBlock(world, x + 1, y) == BlockType::WATER ||
+                                getBlock(world, x, y - 1) == BlockType::WATER || getBlock(world, x, y + 1) == BlockType::WATER)
+                        {
+                                m_solidifiedCells.push_back(packPos(x, y));
+                                return;
+                        }
+                }
+
+                const uint64_t pos = packPos(x, y);
+                int remaining = level;
+
+                // Step 1] Pour as much fluid as possible in the cell below
+                if(canFlowInto(world, x, y - 1, fluid))
+                {
+                        uint8_t belowLevel = 0;
+                        getBlock(world, x, y - 1, &belowLevel);
+
+                        int amount = std::min(remaining, MAX_FLUID_LEVEL - belowLevel);
+                        if(amount > 0)
+                        {
+                                uint64_t belowPos = packPos(x, y - 1);
+                                m_levelDeltas[pos] -= amount;
+                                m_levelDeltas[belowPos] += amount;
+                                m_fluidTypes[belowPos] = fluid;
+                                remaining -= amount;
+                        }
+                }
+
+                if(remaining == 0)
+                        return;
+
+                // A full cell with more fluid above is pushed sideways by the weight of such fluid
+                uint8_t aboveLevel = 0;
+                const bool isPressed = remaining == MAX_FLUID_LEVEL && getBlock(world, x, y + 1, &aboveLevel) == fluid && aboveLevel > 0;
+
+                // Step 2] Share the remaining fluid with the left and right cells, both amounts are computed from the same
+                // remaining value, their sum is capped to it (a single unit that could go on both sides goes to the left one)
+                int sideOutflow = 0;
+                for(int side = -1; side <= 1; side += 2)
+                {
+                        if(!canFlowInto(world, x + side, y, fluid))
+                                continue;
+
+                        uint8_t sideLevel = 0;
+                        getBlock(world, x + side, y, &sideLevel);
+
+                        // A single unit of fluid is moved only if it can fall from the target cell or if the cell is pressed
+                        // (and so it will be filled again from above), otherwise it would keep moving back and forth between the two cells
+                        int difference = remaining - sideLevel;
+                        if(difference < 1 || (difference == 1 && !isPressed && (sideLevel != 0 || !canFallFrom(world, x + side, y, fluid))))
+                                continue;
+
+                        // The free space of the target cell is split between its left and right neighbors
+                        int capacity = getSideCapacity(world, x + side, y);
+                        capacity = side > 0 ? (capacity + 1) / 2 : capacity / 2;
+
+                        int amount = std::min( { std::max(1, difference / 3), capacity, remaining - sideOutflow } );
+                        if(amount > 0)
+                        {
+                                uint64_t sidePos = packPos(x + side, y);
+                                m_levelDeltas[pos] -= amount;
+                                m_levelDeltas[sidePos] += amount;
+                                m_fluidTypes[sidePos] = fluid;
+                                sideOutflow += amount;
+                        }
+                }
+        }
+
+
+        // Applies the changes accumulated in the back buffer to the world and activates the cells around them, the blocks that
+        // change type are written as block edits (so that they are journaled, checked for gravity and update the ticks of
+        // their chunk like any other edit) and then the new fluid levels are written
+        // @world: the world in which changes must be applied
+        void FluidSimulator::applyChanges(GameWorld& world)
+        {
+                for(uint64_t pos : m_solidifiedCells)
+                {
+                        int x = unpackX(pos);
+                        int y = unpackY(pos);
+
+                        Chunk* c = world.findChunk(x, y);
+                        if(c == nullptr)
+                                continue;
+
+                        size_t index = c->getBlockIndex(x, y);
+                        m_blockEdits.push_back( { x, y, c->fluidLevels[index] == MAX_FLUID_LEVEL ? BlockType::OBSIDIAN : BlockType::COBBLESTONE } );
+                        m_levelDeltas.erase(pos);
+                }
+
+                for(const auto& delta : m_levelDeltas)
+                {
+                        if(delta.second == 0)
+                                continue;
+
+                        int x = unpackX(delta.first);
+                        int y = unpackY(delta.first);
+
+                        Chunk* c = world.findChunk(x, y);
+                        if(c == nullptr)
+                                continue;
+
+                        size_t index = c->getBlockIndex(x, y);
+                        BlockType oldBlock = c->blocks[index];
+
+                        // The flows never take more fluid than a cell holds nor add more than it can contain
+                        int newLevel = c->fluidLevels[index] + delta.second;
+                        assert(newLevel >= 0 && newLevel <= (int) MAX_FLUID_LEVEL);
+                        if(newLevel == 0 && oldBlock != BlockType::AIR)
+                                m_blockEdits.push_back( { x, y, BlockType::AIR } );
+                        else if(newLevel != 0 && !isFluid(oldBlock))
+                                m_blockEdits.push_back( { x, y, m_fluidTypes[delta.first] } );
+
+                        m_newLevels.push_back( { delta.first, (uint8_t) newLevel } );
+                }
+
+                // The edits set the fluid level of the new fluid blocks to the maximum, their real level is written after them
+                if(!m_blockEdits.empty())
+                        world.applyBlockEdits(m_blockEdits);
+
+                for(const auto& level : m_newLevels)
+                {
+                        int x = unpackX(level.first);
+                        int y = unpackY(level.first);
+
+                        Chunk* c = world.findChunk(x, y);
+                        if(c == nullptr)
+                                continue;
+
+                        c->fluidLevels[c->getBlockIndex(x, y)] = level.second;
+                        c->invalidateSnapshot();
+                        onBlockChanged(x, y);
+                }
+
+                if(!m_newLevels.empty())
+                        world.m_hasChanged = true;
+
+                m_levelDeltas.clear();
+                m_fluidTypes.clear();
+                m_solidifiedCells.clear();
+                m_blockEdits.clear();
+                m_newLevels.clear();
+        }
+
+
+        // Determines if the given fluid can flow into the cell at the given position
+        // @world: the world that contains the cell
+        // @x: x coordinate of the cell in world space
+        // @y: y coordinate of the cell in world space
+        // @fluid: the type of fluid that should flow into the cell
+        // @returns: true if the cell contains air or the same fluid, empty cells that may receive the other type of
+        // fluid too are considered blocked so that water and lava never get mixed in one cell
+        bool FluidSimulator::canFlowInto(GameWorld& world, int x, int y, BlockType fluid)
+        {
+                BlockType block = getBlock(world, x, y);
+                if(block == fluid)
+                        return true;
+
+                if(block != BlockType::AIR || world.findChunk(x, y) == nullptr)
+                        return false;
+
+                BlockType otherFluid = fluid == BlockType::WATER ? BlockType::LAVA : BlockType::WATER;
+                return getBlock(world, x, y + 1) != otherFluid && getBlock(world, x - 1, y) != otherFluid && getBlock(world, x + 1, y) != otherFluid;
+        }
+
+
+        // Determines if some fluid placed in the cell at the given position would flow down in the next tick
+        // @world: the world that contains the cell
+        // @x: x coordinate of the cell in world space
+        // @y: y coordinate of the cell in world space
+        // @fluid: the type of fluid placed in the cell
+        bool FluidSimulator::canFallFrom(GameWorld& world, int x, int y, BlockType fluid)
+        {
+                uint8_t belowLevel = 0;
+                getBlock(world, x, y - 1, &belowLevel);
+
+                return belowLevel < MAX_FLUID_LEVEL && canFlowInto(world, x, y - 1, fluid);
+        }
+
+
+        // Returns the amount of fluid that the given cell can receive from its left and right neighbors, the amount
+        // that may be poured from the cell above is reserved so that the cell never gets more fluid than it can contain
+        // @world: the world that contains the cell
+        // @x: x coordinate of the cell in world space
+        // @y: y coordinate of the cell in world space
+        uint8_t FluidSimulator::getSideCapacity(GameWorld& world, int x, int y)
+        {
+                uint8_t level = 0;
+                uint8_t aboveLevel = 0;
+                getBlock(world, x, y, &level);
+
+                int freeSpace = MAX_FLUID_LEVEL - level;
+                if(isFluid(getBlock(world, x, y + 1, &aboveLevel)))
+                        freeSpace -= std::min<int>(aboveLevel, freeSpace);
+
+                return (uint8_t) freeSpace;
+        }
+
+
+        // Returns the block at the given position
+        // @world: the world that contains the block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @level: if not null the fluid level of the block is written in it
+        // @returns: the block type, if the block is not in a loaded chunk then air is returned
+        BlockType FluidSimulator::getBlock(GameWorld& world, int x, int y, uint8_t* level)
+        {
+                Chunk* c = world.findChunk(x, y);
+                if(c == nullptr)
+                {
+                        if(level != nullptr)
+                                *level = 0;
+
+                        return BlockType::AIR;
+                }
+
+                size_t index = c->getBlockIndex(x, y);
+                if(level != nullptr)
+                        *level = c->fluidLevels[index];
+
+                return c->blocks[index];
+        }
+
+
+        // Adds the cell at the given position to the active cells (if not already present)
+        // @x: x coordinate of the cell in world space
+        // @y: y coordinate of the cell in world space
+        void FluidSimulator::activateCell(int x, int y)
+        {
+                if(y < 0 || y >= (int) Chunk::height)
+                        return;
+
+                uint64_t pos = packPos(x, y);
+                if(m_activeCells.insert(pos).second)
+                        m_activeQueue.push_back(pos);
+        }
+
+}
@@ -0,0 +1,92 @@
+
+// Contains definition of the FluidSimulator class, this class implements the flow of water and lava using a cellular automaton.
+//
+// Each fluid block holds an amount of fluid (its level) in range [1, MAX_FLUID_LEVEL], the total amount of fluid is preserved
+// while it flows: each tick a fluid cell first pours as much as possible in the cell below and then shares what remains with
+// its left and right neighbors.
+//
+// Only the active cells (cells whose neighborhood changed recently) are processed, a cell that does not move any fluid
+// becomes inactive until something changes around it again. Each tick is double buffered: the flows of all the processed
+// cells are computed from the current state of the world and applied all together at the end of the tick, so the result
+// does not depend on the order in which cells are processed. The number of cells processed in one tick is limited by a
+// budget, cells that exceed the budget are processed in the next ticks.
+// Cells of the chunks that are not ticking are parked with their chunk (and queued again when it ticks again), lava cells
+// wait in their own queue that is processed only in the lava flow ticks, so neither of them is scanned again in each tick.
+// The blocks that change type (fluid that fills an empty cell, dries up or solidifies) are written through
+// GameWorld::applyBlockEdits(), only the fluid levels are written directly.
+//
+
+#ifndef FLUID_SIMULATOR_H
+#define FLUID_SIMULATOR_H
+
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+        struct Chunk;
+
+
+        constexpr uint8_t MAX_FLUID_LEVEL = 8;                  // Amount of fluid contained in a full fluid block
+        constexpr size_t DEFAULT_FLUID_CELLS_BUDGET = 4096;     // Default maximum number of fluid cells processed in one tick
+        constexpr uint64_t LAVA_FLOW_INTERVAL = 4;              // Lava flows only once every LAVA_FLOW_INTERVAL ticks
+
+
+        class FluidSimulator {
+        public:
+                FluidSimulator();
+                ~FluidSimulator() = default;
+
+                void                    tick(GameWorld& world, uint64_t currTick);
+
+                void                    onChunkLoaded(Chunk& chunk);
+                void                    onChunkTierChanged(const Chunk& chunk);
+                void                    onBlockChanged(int x, int y);
+
+                inline void             setCellsBudget(size_t budget)           { m_cellsBudget = budget > 0 ? budget : 1; }
+                inline size_t           getCellsBudget() const                  { return m_cellsBudget; }
+                inline size_t           getActiveCellsNum() const               { return m_activeCells.size(); }
+
+                static inline bool      isFluid(BlockType block)                { return block == BlockType::WATER || block == BlockType::LAVA; }
+
+        private:
+
+                void                    processQueue(GameWorld& world, std::deque<uint64_t>& queue, bool isLavaTick, size_t& processedCells);
+                void                    computeFlow(GameWorld& world, int x, int y);
+                void                    applyChanges(GameWorld& world);
+
+                bool                    canFlowInto(GameWorld& world, int x, int y, BlockType fluid);
+                bool                    canFallFrom(GameWorld& world, int x, int y, BlockType fluid);
+                uint8_t                 getSideCapacity(GameWorld& world, int x, int y);
+                BlockType               getBlock(GameWorld& world, int x, int y, uint8_t* level = nullptr);
+                void                    activateCell(int x, int y);
+
+                static inline uint64_t  packPos(int x, int y)                   { return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y; }
+                static inline int       unpackX(uint64_t pos)                   { return (int) (uint32_t) (pos >> 32); }
+                static inline int       unpackY(uint64_t pos)                   { return (int) (uint32_t) pos; }
+
+                size_t                                  m_cellsBudget;          // Maximum number of cells processed in one tick
+                std::deque<uint64_t>                    m_activeQueue;          // Active cells in the order in which they will be processed
+                std::deque<uint64_t>                    m_lavaQueue;            // Active lava cells waiting for the next lava flow tick
+                std::unordered_map<int, std::vector<uint64_t>> m_parkedCells;   // Active cells of the chunks that are not ticking (by chunk id)
+                std::unordered_set<uint64_t>            m_activeCells;          // Cells of the queues and parked cells, used to avoid duplicates
+
+                // Back buffer of the simulation, filled while computing the flows and applied at the end of the tick
+                std::unordered_map<uint64_t, int>       m_levelDeltas;          // Amount of fluid gained (or lost) by each cell
+                std::unordered_map<uint64_t, BlockType> m_fluidTypes;           // Type of fluid that flows into each cell
+                std::vector<uint64_t>                   m_solidifiedCells;      // Lava cells that touched water and must become solid
+                std::vector<BlockEdit>                  m_blockEdits;           // Cells whose block type changes in the current tick
+                std::vector<std::pair<uint64_t, uint8_t>> m_newLevels;          // New fluid level of each cell changed in the current tick
+        };
+
+}
+
+#endif // FLUID_SIMULATOR_H
@@ -0,0 +1,185 @@
+
+#include "forkedWorldSaver.hpp"
+#include "gameWorld.hpp"
+#include "worldLoader.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+#ifdef __linux__
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#endif
+
+namespace mc2d {
+
+
+        ForkedWorldSaver::ForkedWorldSaver() : m_childPid(0), m_resultPipe(-1), m_pauseDuration(0.0f), m_journalSeq(0), m_syncResult(SaveState::IDLE)
+        {}
+
+
+        // Waits for the save that is running (if any), the owner of the saver should call wait() before so that the eviction
+        // of the chunks of its world gets resumed
+        ForkedWorldSaver::~ForkedWorldSaver()
+        {
+#ifdef __linux__
+                if(isRunning())
+                {
+                        waitpid(m_childPid, nullptr, 0);
+                        close(m_resultPipe);
+                }
+#endif
+        }
+
+
+        // Starts saving the given world (in a child process), the result must be checked with poll() or wait()
+        // @worldDirPath: path to the directory in which the world data should be saved
+        // @world: the world to save
+        // @returns: true if the save has been started, false otherwise
+        bool ForkedWorldSaver::start(const std::filesystem::path& worldDirPath, GameWorld& world)
+        {
+                if(isRunning())
+                {
+                        logWarn("ForkedWorldSaver::start() failed, the previous save is still running!");
+                        return false;
+                }
+
+                if(worldDirPath.empty())
+                {
+                        logError("ForkedWorldSaver::start() failed, the path to the directory in which world data should be saved is empty!");
+                        return false;
+                }
+
+                std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+                // The chunks waiting to be written are not part of the world seen by the child, they are written in the old
+                // directory by the ChunkWriter so they must be there before the world moves to another one
+                if(worldDirPath != world.getWorldSaveDirectory())
+                        world.flushChunkWrites();
+
+                // The child writes the parked entities in their chunks, this process must not keep them parked too
+                world.storeParkedEntities();
+
+                m_journalSeq = world.getBlockJournal().getNextSeq();
+
+#ifdef __linux__
+                int fds[2];
+                if(pipe2(fds, O_CLOEXEC) != 0)
+                {
+                        logError("ForkedWorldSaver::start() failed, cannot create the pipe used to report the result of the save!");
+                        return false;
+                }
+
+                // Output still buffered would be written by both processes
+                fflush(stdout);
+                fflush(stderr);
+
+                pid_t pid = fork();
+                if(pid < 0)
+                {
+                        logError("ForkedWorldSaver::start() failed, cannot fork the process!");
+                        close(fds[0]);
+                        close(fds[1]);
+                        return false;
+                }
+
+                // The child saves its frozen copy of the world and exits without running any destructor (the other
+                // threads of the game do not exist in the child, their objects must not be touched)
+                if(pid == 0)
+                {
+                        close(fds[0]);
+
+                        uint8_t result = WorldLoader::saveWorld(worldDirPath, world) ? 1 : 0;
+                        bool reported = write(fds[1], &result, 1) == 1;
+
+                        fflush(stdout);
+                        fflush(stderr);
+                        _exit(result == 1 && reported ? 0 : 1);
+                }
+
+                close(fds[1]);
+                fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+                m_childPid = pid;
+                m_resultPipe = fds[0];
+
+                world.setWorldSaveDirectory(worldDirPath);
+                world.pauseChunkWrites(true);
+#else
+                m_syncResult = finish(world, WorldLoader::saveWorld(worldDirPath, world));
+#endif
+
+                m_pauseDuration = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+                return true;
+        }
+
+
+        // Checks (without blocking) if the last save has finished
+        // @world: the world that is being saved
+        // @returns: the state of the save, the result of a save is returned only once (IDLE is returned after it)
+        SaveState ForkedWorldSaver::poll(GameWorld& world)
+        {
+#ifdef __linux__
+                if(!isRunning())
+                        return SaveState::IDLE;
+
+                uint8_t result = 0;
+                ssize_t bytesRead = read(m_resultPipe, &result, 1);
+                if(bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                        return SaveState::RUNNING;
+
+                // If the pipe has been closed without a result then the child has crashed
+                return finish(world, bytesRead == 1 && result == 1);
+#else
+                SaveState result = m_syncResult;
+                m_syncResult = SaveState::IDLE;
+                return result;
+#endif
+        }
+
+
+        // Waits until the last save has finished
+        // @world: the world that is being saved
+        // @returns: the result of the save (IDLE if no save was running)
+        SaveState ForkedWorldSaver::wait(GameWorld& world)
+        {
+#ifdef __linux__
+                if(isRunning())
+                        fcntl(m_resultPipe, F_SETFL, 0);
+#endif
+
+                SaveState result = poll(world);
+                while(result == SaveState::RUNNING)
+                        result = poll(world);
+
+                return result;
+        }
+
+
+        // Collects the child process of a save that has finished, resumes the writes of the chunks of the world and compacts
+        // its block journal (if the save succeeded)
+        // @world: the world that has been saved
+        // @succeeded: true if the child has reported that the save succeeded
+        // @returns: the result of the save
+        SaveState ForkedWorldSaver::finish(GameWorld& world, bool succeeded)
+        {
+#ifdef __linux__
+                int status = 0;
+                waitpid(m_childPid, &status, 0);
+                close(m_resultPipe);
+
+                m_childPid = 0;
+                m_resultPipe = -1;
+                world.pauseChunkWrites(false);
+
+                succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+                if(succeeded && !world.compactBlockJournal(m_journalSeq))
+                        logWarn("ForkedWorldSaver::finish(), the world has been saved but the last write of its block journal failed!");
+
+                return succeeded ? SaveState::SUCCEEDED : SaveState::FAILED;
+        }
+
+}
@@ -0,0 +1,66 @@
+
+// Contains definition of the ForkedWorldSaver class, this class saves a game world without stopping the game.
+//
+// On Linux the process is forked: the child process gets a copy-on-write image of the memory of the parent, so it sees the
+// world frozen at the moment of the fork and can write it to disk (see WorldLoader::saveWorld()) while the parent keeps
+// running. The main thread stops only for the fork itself, no matter how large the world is. The child reports the result
+// with one byte written in a pipe, the parent checks it with poll() (without blocking).
+// While a save is running the parent does not write any chunk file (eviction from the chunk cache is paused), otherwise
+// the child could overwrite a newer version of a chunk with the frozen one. When the save succeeds the edits contained in
+// the saved chunks are dropped from the block journal of the world (see BlockJournal).
+// On the other systems the world is saved synchronously by start().
+//
+
+#ifndef FORKED_WORLD_SAVER_H
+#define FORKED_WORLD_SAVER_H
+
+#include <filesystem>
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+
+
+        enum class SaveState : uint8_t {
+                IDLE,                                           // No save has been started (or its result has already been returned)
+                RUNNING,
+                SUCCEEDED,
+                FAILED
+        };
+
+
+        class ForkedWorldSaver {
+        public:
+                ForkedWorldSaver();
+                ~ForkedWorldSaver();
+
+                // Delete copy constructors
+                ForkedWorldSaver(const ForkedWorldSaver& other) = delete;
+                ForkedWorldSaver&       operator = (const ForkedWorldSaver& other) = delete;
+
+                bool                    start(const std::filesystem::path& worldDirPath, GameWorld& world);
+                SaveState               poll(GameWorld& world);
+                SaveState               wait(GameWorld& world);
+
+                inline bool             isRunning() const                       { return m_childPid > 0; }
+
+                // Returns the time for which the main thread has been stopped by the last save (in milliseconds)
+                inline float            getPauseDuration() const                { return m_pauseDuration; }
+
+        private:
+
+                SaveState               finish(GameWorld& world, bool succeeded);
+
+                int                     m_childPid;             // Id of the process that is saving the world (zero if no save is running)
+                int                     m_resultPipe;           // Read end of the pipe in which the child writes the result of the save
+                float                   m_pauseDuration;
+                uint64_t                m_journalSeq;           // Sequence number of the block journal of the world when the last save has been started
+                SaveState               m_syncResult;           // Result of the last synchronous save (on the systems without fork)
+        };
+
+}
+
+#endif // FORKED_WORLD_SAVER_H
@@ -2,6 +2,7 @@
 #include "gameWorld.hpp"
 #include "worldGenerator.hpp"
 #include "worldLoader.hpp"
+#include "worldEncyclopedia.hpp"
 #include "graphics/camera.hpp"
 
 namespace mc2d {
@@ -18,6 +19,19 @@ namespace mc2d {
                         return false;
                 }
 
+                // The arrays are reserved here so that they do not come from the ChunkBufferPool (compressed chunks are
+                // written by the ChunkWriter thread)
+                if(isCompressed())
+                {
+                        Chunk decompressed = *this;
+                        decompressed.blocks.reserve(Chunk::width * Chunk::height);
+                        decompressed.fluidLevels.reserve(Chunk::width * Chunk::height);
+                        decompressed.skyLight.reserve(Chunk::width * Chunk::height);
+                        decompressed.blockLight.reserve(Chunk::width * Chunk::height);
+                        decompressed.decompress();
+                        return decompressed.serialize(file);
+                }
+
                 bool res = true;
 
                 // First we save the chunk biome type
@@ -42,12 +56,239 @@ namespace mc2d {
                 for(auto s = interChunkStructures.begin(); s != interChunkStructures.end() && res != false; ++s)
                         res = s->serialize(file);
 
-                // And then data about all the entities contained in this chunk
+                // Then data about all the entities contained in this chunk
                 file << entities.size() << '\n';
                 for(auto e = entities.begin(); e != entities.end() && res != false; ++e)
                         res = e->serialize(file);
 
-                return res;
+                // And then the levels of the fluid blocks that are not full (as pairs of block index and fluid level)
+                size_t partialFluidsNum = 0;
+                for(uint8_t level : fluidLevels)
+                        partialFluidsNum += (level != 0 && level != MAX_FLUID_LEVEL);
+
+                file << partialFluidsNum << '\n';
+                for(size_t i = 0; i < fluidLevels.size(); ++i)
+                {
+                        if(fluidLevels[i] != 0 && fluidLevels[i] != MAX_FLUID_LEVEL)
+                                file << i << ' ' << static_cast<uint32_t>(fluidLevels[i]) << ' ';
+                }
+
+                file << '\n';
+
+                // And finally the ticks pending for the blocks in the chunk
+                file << scheduledTicks.size() << '\n';
+                for(const ScheduledTick& t : scheduledTicks)
+                        file << t.x << ' ' << t.y << ' ' << t.delay << ' ' << static_cast<uint32_t>(t.block) << '\n';
+
+                // And the sequence number of the first edit of the block journal that is not contained in the chunk
+                file << journalSeq << '\n';
+
+                return res && file.good();
+        }
+
+
+        // Computes the masks of the collidable blocks for all the rows of the chunk
+        void Chunk::computeCollidableRows()
+        {
+                collidableRows.assign(Chunk::height, 0);
+                for(size_t i = 0; i < blocks.size(); ++i)
+                {
+                        if(WorldEncyclopedia::getBlockProperties(blocks[i]).collidable)
+                                collidableRows[Chunk::height - 1 - (i / Chunk::width)] |= 1u << (i % Chunk::width);
+                }
+        }
+
+
+        // Updates the mask of the collidable blocks after a change of the block at the given coordinates
+        // @x: x coordinate of the block in world space (must be inside the chunk)
+        // @y: y coordinate of the block in world space (must be inside the chunk)
+        void Chunk::updateCollidableBit(int x, int y)
+        {
+                const uint32_t bit = 1u << (x - id * Chunk::width);
+                if(WorldEncyclopedia::getBlockProperties(blocks[getBlockIndex(x, y)]).collidable)
+                        collidableRows[y] |= bit;
+                else
+                        collidableRows[y] &= ~bit;
+        }
+
+
+        // Appends the values of an array to the given buffer as pairs of run length and value
+        // @values: the values to encode
+        // @count: number of values
+        // @out: buffer in which the runs are appended
+        static void packRuns(const uint8_t* values, size_t count, std::vector<uint8_t>& out)
+        {
+                for(size_t i = 0; i < count; )
+                {
+                        size_t run = 1;
+                        while(i + run < count && run < UINT8_MAX && values[i + run] == values[i])
+                                ++run;
+
+                        out.push_back((uint8_t) run);
+                        out.push_back(values[i]);
+                        i += run;
+                }
+        }
+
+
+        // Decodes the runs written by packRuns()
+        // @in: buffer that contains the runs
+        // @pos: position of the first run in the buffer
+        // @values: array in which the values are written
+        // @count: number of values to decode
+        // @returns: position in the buffer after the last run decoded
+        static size_t unpackRuns(const std::vector<uint8_t>& in, size_t pos, uint8_t* values, size_t count)
+        {
+                for(size_t i = 0; i < count && pos + 1 < in.size(); pos += 2)
+                {
+                        std::fill_n(values + i, in[pos], in[pos + 1]);
+                        i += in[pos];
+                }
+
+                return pos;
+        }
+
+
+        // Appends an array of values (that must be empty or contain one value for each block) to the packed data of a chunk:
+        // a flag that tells if the array is empty followed by its runs
+        // @values: the array to encode
+        // @out: the packed data
+        static void packArray(const std::vector<uint8_t>& values, std::vector<uint8_t>& out)
+        {
+                out.push_back(values.empty() ? 0 : 1);
+                packRuns(values.data(), values.size(), out);
+        }
+
+
+        // Decodes an array written by packArray()
+        // @in: the packed data
+        // @pos: position of the array in the packed data
+        // @values: vector in which the values are written (left empty if the array was empty)
+        // @returns: position in the packed data after the array
+        static size_t unpackArray(const std::vector<uint8_t>& in, size_t pos, std::vector<uint8_t>& values)
+        {
+                if(pos >= in.size() || in[pos] == 0)
+                        return pos + 1;
+
+                if(values.capacity() == 0)
+                        values = ChunkBufferPool::acquireLevels();
+
+                values.resize(Chunk::width * Chunk::height);
+                return unpackRuns(in, pos + 1, values.data(), values.size());
+        }
+
+
+        // Replaces the blocks, the fluid levels and the light levels of the chunk with a run length encoding of them (the
+        // chunk must be decompressed before its blocks can be used again)
+        void Chunk::compress()
+        {
+                static_assert(sizeof(BlockType) == sizeof(uint8_t), "Blocks are compressed as bytes");
+
+                if(isCompressed())
+                        return;
+
+                // The runs are encoded in a scratch buffer (that keeps its memory between calls) so that the packed data
+                // gets allocated only once, with its exact size
+                static thread_local std::vector<uint8_t> scratch;
+
+                scratch.clear();
+                packRuns(reinterpret_cast<const uint8_t*>(blocks.data()), blocks.size(), scratch);
+                packArray(fluidLevels, scratch);
+                packArray(skyLight, scratch);
+                packArray(blockLight, scratch);
+                packedData.assign(scratch.begin(), scratch.end());
+
+                releaseBuffers();
+        }
+
+
+        // Restores the arrays of a compressed chunk
+        void Chunk::decompress()
+        {
+                if(!isCompressed())
+                        return;
+
+                if(blocks.capacity() == 0)
+                        blocks = ChunkBufferPool::acquireBlocks();
+
+                blocks.resize(Chunk::width * Chunk::height);
+                size_t pos = unpackRuns(packedData, 0, reinterpret_cast<uint8_t*>(blocks.data()), blocks.size());
+                pos = unpackArray(packedData, pos, fluidLevels);
+                pos = unpackArray(packedData, pos, skyLight);
+                unpackArray(packedData, pos, blockLight);
+
+                packedData = std::vector<uint8_t>();
+        }
+
+
+        // Gives the blocks, the fluid levels and the light levels of the chunk back to the ChunkBufferPool (the arrays are
+        // left empty)
+        void Chunk::releaseBuffers()
+        {
+                ChunkBufferPool::release(blocks);
+                ChunkBufferPool::release(fluidLevels);
+                ChunkBufferPool::release(skyLight);
+                ChunkBufferPool::release(blockLight);
+        }
+
+
+        // Returns a snapshot of the blocks, fluid and light levels of the chunk (it can be compressed), the last snapshot is
+        // returned again if the chunk has not been edited since it has been taken
+        // @tick: current tick of the world
+        std::shared_ptr<const ChunkSnapshot> Chunk::takeSnapshot(uint64_t tick)
+        {
+                if(snapshot != nullptr)
+                        return snapshot;
+
+                std::shared_ptr<ChunkSnapshot> s = std::make_shared<ChunkSnapshot>();
+                s->id = id;
+                s->biome = biome;
+                s->tick = tick;
+
+                if(isCompressed())
+                {
+                        s->blocks.resize(Chunk::width * Chunk::height);
+                        size_t pos = unpackRuns(packedData, 0, reinterpret_cast<uint8_t*>(s->blocks.data()), s->blocks.size());
+                        s->fluidLevels.reserve(Chunk::width * Chunk::height);
+                        s->skyLight.reserve(Chunk::width * Chunk::height);
+                        s->blockLight.reserve(Chunk::width * Chunk::height);
+                        pos = unpackArray(packedData, pos, s->fluidLevels);
+                        pos = unpackArray(packedData, pos, s->skyLight);
+                        unpackArray(packedData, pos, s->blockLight);
+                } else {
+                        s->blocks = blocks;
+                        s->fluidLevels = fluidLevels;
+                        s->skyLight = skyLight;
+                        s->blockLight = blockLight;
+                }
+
+                snapshot = s;
+                return snapshot;
+        }
+
+
+        // Returns a block of a compressed chunk without decompressing it
+        // @index: index of the block (relative to the blocks vector)
+        BlockType Chunk::getPackedBlock(size_t index) const
+        {
+                for(size_t pos = 0, i = 0; pos + 1 < packedData.size(); pos += 2)
+                {
+                        i += packedData[pos];
+                        if(index < i)
+                                return static_cast<BlockType>(packedData[pos + 1]);
+                }
+
+                return BlockType::AIR;
+        }
+
+
+        // Returns an estimate of the memory used by the chunk (in bytes)
+        size_t Chunk::getMemoryUsage() const
+        {
+                return sizeof(Chunk) + blocks.capacity() * sizeof(BlockType) + entityHandles.capacity() * sizeof(EntityHandle) +
+                        entities.capacity() * sizeof(Entity) + interChunkStructures.capacity() * sizeof(Structure) +
+                        skyLight.capacity() + blockLight.capacity() + fluidLevels.capacity() + scheduledTicks.capacity() * sizeof(ScheduledTick) +
+                        collidableRows.capacity() * sizeof(uint32_t) + packedData.capacity();
         }
 
 
@@ -66,7 +307,7 @@ namespace mc2d {
                 uint32_t biomeType;
                 uint8_t expectedChunkWidth;
                 uint8_t expectedChunkHeight;
-                std::vector<BlockType> blocks;
+                std::vector<BlockType> blocks = ChunkBufferPool::acquireBlocks();
 
                 size_t entitiesNum;
                 std::vector<Entity> entities;
@@ -74,6 +315,12 @@ namespace mc2d {
                 size_t interChunkStructuresNum;
                 std::vector<Structure> interChunkStructures;
 
+                size_t partialFluidsNum;
+                std::vector<uint8_t> fluidLevels = ChunkBufferPool::acquireLevels();
+
+                size_t scheduledTicksNum;
+                std::vector<ScheduledTick> scheduledTicks;
+
                 file >> biomeType;                              // Read biome type of the chunk
                 file >> expectedChunkWidth;                     // Read width of the chunk
                 file >> expectedChunkHeight;                    // Read height of the chunk
@@ -116,7 +363,7 @@ namespace mc2d {
 
                 // And then we read data about all the entities contained in the chunk
                 file >> entitiesNum;
-                blocks.reserve(entitiesNum);
+                entities.reserve(entitiesNum);
                 for(size_t i = 0; i < entitiesNum; ++i)
                 {
                         Entity e(glm::vec3(0.0f), 100.0f, EntityType::CHICKEN);
@@ -129,11 +376,68 @@ namespace mc2d {
                         entities.push_back(e);
                 }
 
+                // And then we read the levels of the fluid blocks that are not full (chunks saved by older versions of the game do not have them)
+                fluidLevels.resize(blocks.size());
+                for(size_t i = 0; i < blocks.size(); ++i)
+                        fluidLevels[i] = FluidSimulator::isFluid(blocks[i]) ? MAX_FLUID_LEVEL : 0;
+
+                if(file >> partialFluidsNum)
+                {
+                        for(size_t i = 0; i < partialFluidsNum; ++i)
+                        {
+                                size_t index;
+                                uint32_t level;
+                                file >> index; file >> level;
+
+                                if(!file.good() || index >= fluidLevels.size())
+                                {
+                                        logError("Chunk::deserialize() failed, cannot read fluid levels!");
+                                        return false;
+                                }
+
+                                fluidLevels[index] = static_cast<uint8_t>(level);
+                        }
+                }
+
+                // And then we read the ticks pending for the blocks in the chunk (chunks saved by older versions of the game do not have them)
+                if(file >> scheduledTicksNum)
+                {
+                        scheduledTicks.reserve(scheduledTicksNum);
+                        for(size_t i = 0; i < scheduledTicksNum; ++i)
+                        {
+                                ScheduledTick t;
+                                uint32_t block;
+                                file >> t.x; file >> t.y; file >> t.delay; file >> block;
+
+                                if(!file.good() || t.x < 0 || t.x >= (int) Chunk::width || t.y < 0 || t.y >= (int) Chunk::height)
+                                {
+                                        logError("Chunk::deserialize() failed, cannot read scheduled ticks!");
+                                        return false;
+                                }
+
+                                t.block = static_cast<BlockType>(block);
+                                scheduledTicks.push_back(t);
+                        }
+                }
+
+                // And finally the sequence number of the block journal (chunks saved by older versions of the game do not have it,
+                // all the edits in the journal are replayed in them)
+                uint64_t journalSeq = 0;
+                if(!(file >> journalSeq))
+                        journalSeq = 0;
+
                 // If we got to this point then deserialization has been successfull and we can use such data to intiialize this chunk
+                // (the arrays replaced go back to the pool)
                 this->biome = static_cast<BiomeType>(biomeType);
+                ChunkBufferPool::release(this->blocks);
+                ChunkBufferPool::release(this->fluidLevels);
                 this->blocks = std::move(blocks);
                 this->entities = std::move(entities);
                 this->interChunkStructures = std::move(interChunkStructures);
+                this->fluidLevels = std::move(fluidLevels);
+                this->scheduledTicks = std::move(scheduledTicks);
+                this->journalSeq = journalSeq;
+                invalidateSnapshot();
 
                 return true;
         }
@@ -142,8 +446,10 @@ namespace mc2d {
         // GameWorld constructor, creates a zero intialized world
         GameWorld::GameWorld() :
                 m_hasChanged(false), m_worldSeed(0), m_dayDuration(0), m_dayTime(0.0f), m_pathToWorldDir(""),
-                m_loadedChunks({}), m_players( { Entity(glm::vec3(0.0f, 0.0f, 0.0f), 100.0f, EntityType::PLAYER) } )
-        {}
+                m_loadedChunks({}), m_players( {} ), m_rng(0), m_currTick(0), m_currStep(0)
+        {
+                addPlayer( Entity(glm::vec3(0.0f, 0.0f, 0.0f), 100.0f, EntityType::PLAYER) );
+        }
 
 
         // Copy constructor
@@ -155,8 +461,32 @@ namespace mc2d {
                 m_dayDuration = otherWorld.m_dayDuration;
                 m_dayTime = otherWorld.m_dayTime;
 
+                // The chunks cached by the other world and the ones it has still to write are not copied, they must be on
+                // disk before the copy loads them (and only one world must write them)
+                otherWorld.m_chunkCache.flush(otherWorld);
+                otherWorld.m_chunkWriter.flush();
+
                 m_loadedChunks = otherWorld.m_loadedChunks;
+                m_chunkCache.setCompression(otherWorld.m_chunkCache.isCompressionEnabled());
+                m_chunkCache.setBudget(*this, otherWorld.m_chunkCache.getBudget());
+                m_blockJournal = otherWorld.m_blockJournal;
+                m_entities = otherWorld.m_entities;
+                m_spatialHash = otherWorld.m_spatialHash;
                 m_players = otherWorld.m_players;
+                m_parkedEntities = otherWorld.m_parkedEntities;
+                m_fluidSimulator = otherWorld.m_fluidSimulator;
+                m_tickScheduler = otherWorld.m_tickScheduler;
+                m_randomTicker = otherWorld.m_randomTicker;
+                m_explosionSimulator = otherWorld.m_explosionSimulator;
+                m_fallingColumns = otherWorld.m_fallingColumns;
+                m_rng = otherWorld.m_rng;
+                m_taskPool = otherWorld.m_taskPool;
+                m_streamingSettings = otherWorld.m_streamingSettings;
+                m_streamingStats = otherWorld.m_streamingStats;
+                m_compressionStats = otherWorld.m_compressionStats;
+
+                m_currTick = otherWorld.m_currTick;
+                m_currStep = otherWorld.m_currStep;
 
                 m_pathToWorldDir = otherWorld.m_pathToWorldDir;
         }
@@ -168,7 +498,7 @@ namespace mc2d {
         // @dayDuration: duration of one day in the world (in milliseconds)
         GameWorld::GameWorld(std::vector<Chunk>&& chunks, unsigned seed, size_t dayDuration) :
                 m_hasChanged(true), m_worldSeed(seed), m_dayDuration(dayDuration), m_pathToWorldDir(""),
-                m_loadedChunks( {} ), m_players( {} )
+                m_loadedChunks( {} ), m_players( {} ), m_rng(seed), m_currTick(0), m_currStep(0)
         {
                 if(chunks.empty())
                 {
@@ -186,12 +516,18 @@ namespace mc2d {
                                 ++id;
                         }
 
+                        for(auto& c : m_loadedChunks)
+                        {
+                                initLoadedChunk(c.second);
+                                thawChunk(c.second);
+                        }
+
                         // Compute spawn position for the main player and insert it in the game world
                         auto rootChunk = m_loadedChunks.find(0);
                         float spawnPosX = Chunk::width / 2.0f;
                         float spawnPosY = WorldEncyclopedia::getBiomeProperties(rootChunk->second.biome).maxTerrainHeight + 2.0f;
 
-                        m_players.emplace_back( glm::vec3(spawnPosX, spawnPosY, 0.0f), 100.0f, EntityType::PLAYER );
+                        addPlayer( Entity(glm::vec3(spawnPosX, spawnPosY, 0.0f), 100.0f, EntityType::PLAYER) );
 
                         setDayTime(7, 0);               // Set day time to 07:00
                 }
@@ -207,38 +543,69 @@ namespace mc2d {
                 m_dayDuration = otherWorld.m_dayDuration;
                 m_dayTime = otherWorld.m_dayTime;
 
+                // The chunks that both worlds have still to write must be on disk before this world loads them (the chunks
+                // cached by this world are written too, they would be lost otherwise)
+                m_chunkCache.flush(*this);
+                otherWorld.m_chunkWriter.flush();
+                m_chunkWriter.flush();
+
                 m_loadedChunks = std::move(otherWorld.m_loadedChunks);
+                m_chunkCache = std::move(otherWorld.m_chunkCache);
+                m_blockJournal = std::move(otherWorld.m_blockJournal);
+                m_entities = std::move(otherWorld.m_entities);
+                m_spatialHash = std::move(otherWorld.m_spatialHash);
                 m_players = std::move(otherWorld.m_players);
+                m_parkedEntities = std::move(otherWorld.m_parkedEntities);
+                m_fluidSimulator = std::move(otherWorld.m_fluidSimulator);
+                m_tickScheduler = std::move(otherWorld.m_tickScheduler);
+                m_randomTicker = otherWorld.m_randomTicker;
+                m_explosionSimulator = otherWorld.m_explosionSimulator;
+                m_fallingColumns = otherWorld.m_fallingColumns;
+                m_rng = otherWorld.m_rng;
+                m_taskPool = otherWorld.m_taskPool;
+                m_streamingSettings = otherWorld.m_streamingSettings;
+                m_streamingStats = otherWorld.m_streamingStats;
+                m_compressionStats = otherWorld.m_compressionStats;
+
+                m_currTick = otherWorld.m_currTick;
+                m_currStep = otherWorld.m_currStep;
 
                 m_pathToWorldDir = otherWorld.m_pathToWorldDir;
                 return *this;
         }
 
 
-        // Updates all the entities contained in the chunks currently loaded
-        void GameWorld::update(float deltaTime)
+        // Advances the world by one simulation step (SIMULATION_STEP_DURATION milliseconds): updates all the entities contained
+        // in the chunks currently loaded and executes a world tick every STEPS_PER_WORLD_TICK steps
+        void GameWorld::update()
         {
-                bool needToRecomputeChunks = false;
-                for(auto& p : m_players)                                // Update all players in the world
-                {
-                        int prevChunkId = getEntityChunkId(p);
-                        p.update(deltaTime);
+                // Players and the entities in all the loaded chunks are updated together by the entity store
+                m_entityCollider.update(*this, SIMULATION_STEP_DURATION);
+                m_spatialHash.rebuild(m_entities);
+
+                // Check if some player needs other chunks (it moved to another chunk or it is going to reach one soon)
+                bool needToRecomputeChunks = m_playersChunkRanges.size() != m_players.size();
+                m_playersChunkRanges.resize(m_players.size());
 
-                        if(getEntityChunkId(p) != prevChunkId)          // Check if a transition between chunks has occurred
-                                needToRecomputeChunks = true;           // If so then we may need to load/unload some chunks
+                for(size_t i = 0; i < m_players.size(); ++i)
+                {
+                        glm::ivec2 range = getPlayerChunkRange(m_players[i]);
+                        needToRecomputeChunks |= range != m_playersChunkRanges[i];
+                        m_playersChunkRanges[i] = range;
                 }
 
-                if(needToRecomputeChunks)                               // Load/unload chunks if needed
+                if(needToRecomputeChunks)                               // If so then we may need to load/unload some chunks
                         recomputeLoadedChunks();
 
-                for(auto& c : m_loadedChunks)                           // Update entities in all loaded chunks
+                // Blocks are simulated at a slower rate than entities
+                if(++m_currStep == STEPS_PER_WORLD_TICK)
                 {
-                        for(auto& e : c.second.entities)
-                                e.update(deltaTime);
+                        tick();
+                        m_currStep = 0;
                 }
 
-                // Update world time (TODO: Still need to implement the day-night cycle)
-                m_dayTime += deltaTime;
+                // Update world time (it controls the intensity of the sky light, see getSkyLightFactor())
+                m_dayTime += SIMULATION_STEP_DURATION;
                 if(m_dayTime > (float) m_dayDuration)
                         m_dayTime = 0.0f;
         }
@@ -264,12 +631,91 @@ namespace mc2d {
                         return;
                 }
 
-                // Compute indexes relative to the blocks array of the chunk
-                size_t xIndex = (size_t) std::floor(x - c->second.getPos().x);
-                size_t yIndex = (size_t) std::floor(c->second.getPos().y - y);
-                
-                c->second.blocks[(yIndex * Chunk::width) + xIndex] = newBlock;
-                m_hasChanged = true;
+                // Compute coordinates of the block in world space
+                int blockX = (searchedChunkId * Chunk::width) + (int) std::floor(x - c->second.getPos().x);
+                int blockY = Chunk::height - 1 - (int) std::floor(c->second.getPos().y - y);
+
+                // Update light only in the region affected by the change
+                if(placeBlock(blockX, blockY, newBlock))
+                {
+                        processGravityChecks();
+                        m_lightEngine.update(*this);
+                }
+        }
+
+
+        // Changes many blocks in one single batch, the light and the blocks affected by gravity are updated only
+        // once after all the changes have been applied
+        // @edits: the changes to apply, changes to blocks that are not in a loaded chunk are ignored
+        void GameWorld::applyBlockEdits(const std::vector<BlockEdit>& edits)
+        {
+                bool blocksChanged = false;
+                for(const BlockEdit& e : edits)
+                        blocksChanged |= placeBlock(e.x, e.y, e.block);
+
+                if(blocksChanged)
+                {
+                        processGravityChecks();
+                        m_lightEngine.update(*this);
+                }
+        }
+
+
+        // Ignites the block at the specified location (if it can be ignited), a TNT block explodes after TNT_FUSE_TICKS ticks
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: true if the block has been ignited, false otherwise
+        bool GameWorld::igniteBlock(float x, float y)
+        {
+                int blockX = (int) std::floor(x);
+                int blockY = (int) std::floor(y);
+
+                Chunk* c = findChunk(blockX, blockY);
+                if(c == nullptr || c->blocks[c->getBlockIndex(blockX, blockY)] != BlockType::TNT)
+                        return false;
+
+                scheduleTick(blockX, blockY, BlockType::TNT, TNT_FUSE_TICKS);
+                return true;
+        }
+
+
+        // Adds a new player to the game world
+        // @player: data of the new player
+        // @returns: the handle of the player in the world entity store
+        EntityHandle GameWorld::addPlayer(const Entity& player)
+        {
+                EntityHandle h = m_entities.create(player);
+                if(h != INVALID_ENTITY_HANDLE)
+                        m_players.push_back(h);
+
+                return h;
+        }
+
+
+        // Adds a new entity (that is not a player) to the chunk that contains it, entities added to a frozen chunk are parked
+        // in the chunk and enter the entity store when the chunk starts ticking
+        // @entity: data of the new entity
+        // @returns: the handle of the entity in the world entity store, INVALID_ENTITY_HANDLE if the entity is not in a ticking chunk
+        EntityHandle GameWorld::addEntity(const Entity& entity)
+        {
+                auto c = m_loadedChunks.find(Chunk::getIdFromBlockX((int) std::floor(entity.getPos().x)));
+                if(c == m_loadedChunks.end())
+                {
+                        logWarn("GameWorld::addEntity() failed, trying to add an entity in a chunk that is not currently loaded in memory!");
+                        return INVALID_ENTITY_HANDLE;
+                }
+
+                if(c->second.tier != ChunkTier::TICKING)
+                {
+                        c->second.entities.push_back(entity);
+                        return INVALID_ENTITY_HANDLE;
+                }
+
+                EntityHandle h = m_entities.create(entity);
+                if(h != INVALID_ENTITY_HANDLE)
+                        c->second.entityHandles.push_back(h);
+
+                return h;
         }
 
 
@@ -309,7 +755,11 @@ namespace mc2d {
                 // Compute indexes relative to the blocks array of the chunk
                 size_t xIndex = (size_t) std::floor(x - c->second.getPos().x);
                 size_t yIndex = (size_t) std::floor(c->second.getPos().y - y);
-                
+
+                // Reading a block does not count as an access, a cold chunk stays compressed
+                if(c->second.isCompressed())
+                        return c->second.getPackedBlock((yIndex * Chunk::width) + xIndex);
+
                 return c->second.blocks[(yIndex * Chunk::width) + xIndex];
         }
 
@@ -333,127 +783,747 @@ namespace mc2d {
         }
 
 
-        // Attempts to find the chunk that contains the given entity
-        // @e: the entity for which we want to find the chunk
-        // @returns: on success a pointer to a chunk, nullptr otherwise
-        Chunk* GameWorld::getEntityChunk(const Entity& e)
+        // Returns the value (in range [MIN_SKY_LIGHT_FACTOR, 1]) by which the sky light must be scaled at the current time of the
+        // day, sky light is at full intensity from mid morning to mid afternoon and is at its minimum from late evening to early morning
+        float GameWorld::getSkyLightFactor() const
         {
-                auto c = m_loadedChunks.find(getEntityChunkId(e));
-                return c == m_loadedChunks.end() ? nullptr : &(c->second);
+                if(m_dayDuration == 0)
+                        return 1.0f;
+
+                // Sun height goes from -1 (at midnight) to 1 (at noon)
+                float dayProgress = m_dayTime / (float) m_dayDuration;
+                float sunHeight = std::sin( (dayProgress - 0.25f) * 2.0f * (float) M_PI );
+
+                return std::clamp(0.5f + sunHeight, MIN_SKY_LIGHT_FACTOR, 1.0f);
         }
 
 
-        // Utility function used to determine all the loaded chunks that are visible from the given camera
-        // @camera: defines the point of view of the world
-        std::vector<Chunk const*> GameWorld::getVisibleChunks(const Camera& camera) const
+        // Advances the simulation of the blocks in the loaded chunks by one tick
+        void GameWorld::tick()
         {
-                std::vector<const Chunk*> intersectedChunks;
-                for(auto& c : m_loadedChunks)
-                {
-                        if(doesRectsIntersect(camera.getPos().x, camera.getPos().y, (float) camera.getWidth(), (float) camera.getHeight(),
-                                                c.second.getPos().x, c.second.getPos().y, (float) Chunk::width, (float) Chunk::height))
-                                intersectedChunks.push_back( &(c.second) );
-                }
+                compressColdChunks();
+
+                m_dueTicks.clear();
+                m_tickScheduler.advance(m_dueTicks);
+
+                for(const ScheduledTick& t : m_dueTicks)
+                        onScheduledTick(t);
+
+                if(!m_dueTicks.empty())
+                        m_lightEngine.update(*this);
 
-                return intersectedChunks;
+                m_explosionSimulator.tick(*this);
+                m_randomTicker.tick(*this, m_currTick);
+                m_fluidSimulator.tick(*this, m_currTick);
+
+                processGravityChecks();
+                updateFallingColumns();
+                m_lightEngine.update(*this);
+
+                migrateEntities();
+
+                ++m_currTick;
         }
 
 
-        // Loads/unloads chunks according to the positions of the players in the game world
-        void GameWorld::recomputeLoadedChunks()
+        // Executes a tick that was scheduled for a block, if the block has changed since the tick was scheduled nothing happens
+        // @t: the tick that is due
+        void GameWorld::onScheduledTick(const ScheduledTick& t)
         {
-                // Maximum value of distance (squared) between a player and a chunk, a chunk will stay in memory until
-                // there is at least one player that has a distance smaller than this value
-                const float maxDistanceSquared = (Chunk::width + Chunk::width / 2.0f) * (Chunk::width + Chunk::width / 2.0f);
+                Chunk* c = findChunk(t.x, t.y);
+                if(c == nullptr || c->blocks[c->getBlockIndex(t.x, t.y)] != t.block)
+                        return;
 
-                // Unload all chunks that are far away from players
-                auto c = m_loadedChunks.begin();
-                while(c != m_loadedChunks.end())                
+                switch(t.block)
                 {
-                        bool unload = true;
-                        float chunkPos = c->second.getPos().x + ((float) Chunk::width / 2.0f);
+                        case BlockType::OAK_SAPLING:    growTree(t.x, t.y, TreeType::OAK); break;
+                        case BlockType::BIRCH_SAPLING:  growTree(t.x, t.y, TreeType::BIRCH); break;
+                        case BlockType::JUNGLE_SAPLING: growTree(t.x, t.y, TreeType::JUNGLE); break;
+                        case BlockType::SPRUCE_SAPLING: growTree(t.x, t.y, TreeType::SPRUCE); break;
+                        case BlockType::FURNACE_ACTIVE: placeBlock(t.x, t.y, BlockType::FURNACE); break;
+                        case BlockType::TNT:            m_explosionSimulator.queueExplosion(t.x, t.y); break;
+                        default:                        break;
+                }
+        }
 
-                        for(auto& p : m_players)
-                        {
-                                if( (p.getPos().x - chunkPos) * (p.getPos().x - chunkPos) < maxDistanceSquared )
-                                {
-                                        unload = false;
-                                        break;
-                                }
-                        }
 
-                        if(unload)
+        // Schedules the first tick of a block that has just been placed (if the block needs one)
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: the type of the block
+        void GameWorld::scheduleBlockTick(int x, int y, BlockType block)
+        {
+                switch(block)
+                {
+                        case BlockType::OAK_SAPLING:
+                        case BlockType::BIRCH_SAPLING:
+                        case BlockType::JUNGLE_SAPLING:
+                        case BlockType::SPRUCE_SAPLING:
                         {
-                                c = unloadChunk(c);
-                                continue;
+                                std::uniform_int_distribution<uint64_t> growthDistrib(SAPLING_MIN_GROWTH_TICKS, SAPLING_MAX_GROWTH_TICKS);
+                                scheduleTick(x, y, block, growthDistrib(m_rng));
+                                break;
                         }
 
-                        ++c;
+                        case BlockType::FURNACE_ACTIVE:
+                                scheduleTick(x, y, block, FURNACE_BURN_TICKS);
+                                break;
+
+                        default:
+                                break;
                 }
+        }
 
-                // Load all chunks near players (for each player the chunks
-                // adjacent to the one in which the player currently is must be loaded)
-                for(auto& p : m_players)
+
+        // Schedules a tick for a block, the ticks of the blocks in a chunk that is not ticking are parked in the chunk (with
+        // the ones stored by freezeChunk()) and go to the tick scheduler when the chunk ticks again
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: the type of the block
+        // @delay: number of ticks after which the block will be updated
+        void GameWorld::scheduleTick(int x, int y, BlockType block, uint64_t delay)
+        {
+                std::vector<ScheduledTick>* parkedTicks = findParkedTicks(x);
+                if(parkedTicks == nullptr)
                 {
-                        int playerChunkId = getEntityChunkId(p);
-                        loadChunk(playerChunkId - 1);
-                        loadChunk(playerChunkId + 1);
+                        m_tickScheduler.schedule(x, y, block, delay);
+                        return;
                 }
+
+                // Only one tick can be pending for each block (like in the tick scheduler)
+                cancelTick(x, y);
+                parkedTicks->push_back( { x - Chunk::getIdFromBlockX(x) * (int) Chunk::width, y, delay, block } );
         }
 
 
-        // Writes the world data in the given file
-        // @file: output file stream in which world data will be written
-        // @returns: true if serialization is successfull, false otherwise
-        bool GameWorld::serialize(std::ofstream& file) const
+        // Cancels the tick pending for a block (in the tick scheduler or parked in its chunk)
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        void GameWorld::cancelTick(int x, int y)
         {
-                if(!file.good())
+                std::vector<ScheduledTick>* parkedTicks = findParkedTicks(x);
+                if(parkedTicks == nullptr)
                 {
-                        logError("GameWorld::serialize() failed, the given file stream is broken!");
-                        return false;
+                        m_tickScheduler.cancel(x, y);
+                        return;
                 }
 
-                bool res = true;
-
-                // First we save the world seed
-                file << m_worldSeed << '\n';
+                const int chunkX = x - Chunk::getIdFromBlockX(x) * (int) Chunk::width;
+                parkedTicks->erase(std::remove_if(parkedTicks->begin(), parkedTicks->end(),
+                        [chunkX, y](const ScheduledTick& t) { return t.x == chunkX && t.y == y; }), parkedTicks->end());
+        }
 
-                // Then the day duration and the current day time
-                file << m_dayDuration << ' ' << m_dayTime << '\n';
 
-                // Then data about all players in the game world
-                file << m_players.size() << '\n';
+        // Returns true if a tick is pending for the given block (in the tick scheduler or parked in its chunk)
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        bool GameWorld::isTickScheduled(int x, int y) const
+        {
+                auto c = m_loadedChunks.find(Chunk::getIdFromBlockX(x));
+                if(c == m_loadedChunks.end() || c->second.tier == ChunkTier::TICKING)
+                        return m_tickScheduler.isScheduled(x, y);
 
-                res = file.good();
+                const int chunkX = x - c->first * (int) Chunk::width;
+                return std::any_of(c->second.scheduledTicks.begin(), c->second.scheduledTicks.end(),
+                        [chunkX, y](const ScheduledTick& t) { return t.x == chunkX && t.y == y; });
+        }
 
-                for(auto p = m_players.begin(); p != m_players.end() && res != false; ++p)
-                        res = p->serialize(file);
 
-                // Then save all the currently loaded chunks
-                for(auto c = m_loadedChunks.begin(); c != m_loadedChunks.end() && res != false; ++c)
-                        res = WorldLoader::saveChunk(m_pathToWorldDir, c->second);
+        // Returns the ticks parked in the loaded chunk that contains the given column if the chunk is not ticking (the chunk
+        // is not decompressed, its ticks are not compressed)
+        // @x: x coordinate of the column in world space
+        // @returns: the parked ticks, nullptr if the chunk is ticking or it is not loaded (its ticks go to the tick scheduler)
+        std::vector<ScheduledTick>* GameWorld::findParkedTicks(int x)
+        {
+                auto c = m_loadedChunks.find(Chunk::getIdFromBlockX(x));
+                if(c == m_loadedChunks.end() || c->second.tier == ChunkTier::TICKING)
+                        return nullptr;
 
-                return res;
+                return &c->second.scheduledTicks;
         }
 
 
-        // Reads world data from the given file
-        // @file: input file stream from which world data will be read
-        // @returns: true if deserialization is successfull, false otherwise
-        bool GameWorld::deserialize(std::ifstream& file)
+        // Replaces the sapling at the given position with a tree, if there is not enough free space above the
+        // sapling then the growth is postponed
+        // @x: x coordinate of the sapling in world space
+        // @y: y coordinate of the sapling in world space
+        // @type: the type of tree that will grow
+        void GameWorld::growTree(int x, int y, TreeType type)
         {
-                if(!file.good())
+                const TreeProperties& props = WorldEncyclopedia::getTreeProperties(type);
+                std::uniform_int_distribution<int> heightDistrib(props.minHeight, props.maxHeight);
+
+                // The log can grow only in air blocks, one more block is needed on top of it for the leaves
+                int maxHeight = 1;
+                for(Chunk* c = findChunk(x, y + 1); c != nullptr && c->blocks[c->getBlockIndex(x, y + maxHeight)] == BlockType::AIR; c = findChunk(x, y + maxHeight))
+                        ++maxHeight;
+
+                int height = std::min(heightDistrib(m_rng), maxHeight - 1);
+                if(height < props.minHeight)
                 {
-                        logError("GameWorld::deserialize() failed, the given file stream is broken!");
-                        return false;
+                        Chunk* c = findChunk(x, y);
+                        scheduleBlockTick(x, y, c->blocks[c->getBlockIndex(x, y)]);
+                        return;
                 }
 
-                // Declare temporary variables to hold the deserialized data
-                unsigned seed;
-                size_t dayDuration;
-                float dayTime;
-                size_t playersNum;
-                std::vector<Entity> players;
+                for(int i = 0; i < height; ++i)
+                        placeBlock(x, y + i, props.logBlockType);
+
+                // Leaves cover the top of the log, the two rows below the top are wider
+                int topY = y + height;
+                for(int leafY = topY - 2; leafY <= topY; ++leafY)
+                {
+                        int halfWidth = leafY == topY ? 1 : 2;
+                        for(int leafX = x - halfWidth; leafX <= x + halfWidth; ++leafX)
+                        {
+                                Chunk* c = findChunk(leafX, leafY);
+                                if(c != nullptr && c->blocks[c->getBlockIndex(leafX, leafY)] == BlockType::AIR)
+                                        placeBlock(leafX, leafY, props.leafBlockType);
+                        }
+                }
+        }
+
+
+        // Detaches the columns of blocks affected by gravity that are no longer supported, each column is removed from the
+        // world at once (so removing the base of a tall column costs the same as removing one block)
+        void GameWorld::processGravityChecks()
+        {
+                // Removing the blocks of a column adds new checks, they are all processed here
+                for(size_t i = 0; i < m_gravityChecks.size(); ++i)
+                {
+                        const glm::ivec2 pos = m_gravityChecks[i];
+
+                        Chunk* c = findChunk(pos.x, pos.y);
+                        if(c == nullptr || !WorldEncyclopedia::getBlockProperties(c->blocks[c->getBlockIndex(pos.x, pos.y)]).gravity)
+                                continue;
+
+                        if(isSupportingBlock(pos.x, pos.y - 1))
+                                continue;
+
+                        FallingColumn column = { pos.x, (float) pos.y, 0.0f, {} };
+                        for(int y = pos.y; y < (int) Chunk::height; ++y)
+                        {
+                                BlockType block = c->blocks[c->getBlockIndex(pos.x, y)];
+                                if(!WorldEncyclopedia::getBlockProperties(block).gravity)
+                                        break;
+
+                                column.blocks.push_back(block);
+                        }
+
+                        // Blocks are removed from the top so that none of them is detached again
+                        for(int y = pos.y + (int) column.blocks.size() - 1; y >= pos.y; --y)
+                                placeBlock(pos.x, y, BlockType::AIR);
+
+                        m_fallingColumns.push_back(std::move(column));
+                }
+
+                m_gravityChecks.clear();
+        }
+
+
+        // Moves all the falling columns down by one tick, the columns that reach a supporting block are written back in the world
+        void GameWorld::updateFallingColumns()
+        {
+                if(m_fallingColumns.empty())
+                        return;
+
+                m_hasChanged = true;
+
+                size_t i = 0;
+                while(i < m_fallingColumns.size())
+                {
+                        FallingColumn& column = m_fallingColumns[i];
+                        column.velocity = std::min(column.velocity + FALLING_BLOCK_GRAVITY, FALLING_BLOCK_MAX_VELOCITY);
+                        float newBottomY = column.bottomY - column.velocity;
+
+                        // Check all the positions crossed by the bottom of the column in this tick
+                        int landingY = INT_MIN;
+                        for(int y = (int) std::floor(column.bottomY); y >= (int) std::ceil(newBottomY) && landingY == INT_MIN; --y)
+                        {
+                                if(isSupportingBlock(column.x, y - 1))
+                                        landingY = y;
+                        }
+
+                        if(landingY == INT_MIN)
+                        {
+                                column.bottomY = newBottomY;
+                                ++i;
+                                continue;
+                        }
+
+                        // The column is removed before landing because landing may detach new columns
+                        FallingColumn landedColumn = std::move(column);
+                        if(i + 1 != m_fallingColumns.size())
+                                m_fallingColumns[i] = std::move(m_fallingColumns.back());
+
+                        m_fallingColumns.pop_back();
+
+                        landColumn(landedColumn, landingY);
+                }
+        }
+
+
+        // Writes the blocks of the given column back in the world as one single batch, blocks that would end up in an
+        // occupied position (for example on top of another column that landed in the same tick) are stacked above it
+        // @column: the column that has landed
+        // @bottomY: y coordinate (in world space) at which the bottom block of the column will be placed
+        void GameWorld::landColumn(const FallingColumn& column, int bottomY)
+        {
+                int y = bottomY;
+                for(BlockType block : column.blocks)
+                {
+                        Chunk* c = findChunk(column.x, y);
+                        while(c != nullptr && isSupportingBlock(column.x, y))
+                                c = findChunk(column.x, ++y);
+
+                        if(c == nullptr)                // Blocks above the top of the world are lost
+                                break;
+
+                        placeBlock(column.x, y++, block);
+                }
+
+                processGravityChecks();
+        }
+
+
+        // Makes the falling columns land immediately in the position in which they would land (used before saving them)
+        // @chunkId: id of the chunk whose falling columns must be dropped
+        // @allChunks: if true the falling columns of all the chunks are dropped
+        void GameWorld::dropColumns(int chunkId, bool allChunks)
+        {
+                size_t i = 0;
+                while(i < m_fallingColumns.size())
+                {
+                        FallingColumn& column = m_fallingColumns[i];
+                        if(!allChunks && Chunk::getIdFromBlockX(column.x) != chunkId)
+                        {
+                                ++i;
+                                continue;
+                        }
+
+                        int y = (int) std::floor(column.bottomY);
+                        while(!isSupportingBlock(column.x, y - 1))
+                                --y;
+
+                        FallingColumn landedColumn = std::move(column);
+                        if(i + 1 != m_fallingColumns.size())
+                                m_fallingColumns[i] = std::move(m_fallingColumns.back());
+
+                        m_fallingColumns.pop_back();
+
+                        landColumn(landedColumn, y);
+                }
+
+                m_lightEngine.update(*this);
+        }
+
+
+        // Determines if the block at the given position can support the blocks affected by gravity
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: true for solid blocks, the bottom of the world and the blocks in chunks that are not loaded
+        bool GameWorld::isSupportingBlock(int x, int y)
+        {
+                Chunk* c = findChunk(x, y);
+                if(c == nullptr)
+                        return true;
+
+                BlockType block = c->blocks[c->getBlockIndex(x, y)];
+                return block != BlockType::AIR && !FluidSimulator::isFluid(block);
+        }
+
+
+        // Changes the block at the given position and notifies all the world subsystems of the change, the light engine
+        // only queues the change so the caller must update it once it has finished placing blocks
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @newBlock: new block to place
+        // @returns: true if the block has changed, false if it was already of the given type or it is not in a loaded chunk
+        bool GameWorld::placeBlock(int x, int y, BlockType newBlock)
+        {
+                Chunk* c = findChunk(x, y);
+                if(c == nullptr)
+                        return false;
+
+                size_t index = c->getBlockIndex(x, y);
+                if(c->blocks[index] == newBlock)
+                        return false;
+
+                c->randomTickBlocksNum -= WorldEncyclopedia::getBlockProperties(c->blocks[index]).randomTicks;
+                c->randomTickBlocksNum += WorldEncyclopedia::getBlockProperties(newBlock).randomTicks;
+
+                c->blocks[index] = newBlock;
+                c->fluidLevels[index] = FluidSimulator::isFluid(newBlock) ? MAX_FLUID_LEVEL : 0;
+                c->invalidateSnapshot();
+                m_blockJournal.record(x, y, newBlock);
+                c->updateCollidableBit(x, y);
+                c->lastAccessTick = m_currTick;
+                m_hasChanged = true;
+
+                m_lightEngine.onBlockChanged(*this, x, y);
+                m_fluidSimulator.onBlockChanged(x, y);
+
+                cancelTick(x, y);
+                scheduleBlockTick(x, y, newBlock);
+
+                // The block above may have lost its support, the new block may have no support
+                m_gravityChecks.push_back( { x, y + 1 } );
+                m_gravityChecks.push_back( { x, y } );
+                return true;
+        }
+
+
+        // Returns the loaded chunk that contains the block at the given coordinates, the chunk is decompressed if needed
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: on success a pointer to a chunk, nullptr if the coordinates are outside of the world or the chunk is not loaded
+        Chunk* GameWorld::findChunk(int x, int y)
+        {
+                if(y < 0 || y >= (int) Chunk::height)
+                        return nullptr;
+
+                auto c = m_loadedChunks.find(Chunk::getIdFromBlockX(x));
+                if(c == m_loadedChunks.end())
+                        return nullptr;
+
+                if(c->second.isCompressed())
+                        decompressChunk(c->second);
+
+                return &(c->second);
+        }
+
+
+        // Returns the loaded chunk that contains the block at the given coordinates without decompressing it (its blocks
+        // must not be read)
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: on success a pointer to a chunk, nullptr if the coordinates are outside of the world or the chunk is not loaded
+        const Chunk* GameWorld::peekChunk(int x, int y) const
+        {
+                if(y < 0 || y >= (int) Chunk::height)
+                        return nullptr;
+
+                auto c = m_loadedChunks.find(Chunk::getIdFromBlockX(x));
+                return c == m_loadedChunks.end() ? nullptr : &(c->second);
+        }
+
+
+        // Compresses the frozen chunks that have not been accessed for a while and decompresses the chunks that are ticking
+        // or next to a ticking chunk (random ticks read them from many threads, so they must never be decompressed then)
+        void GameWorld::compressColdChunks()
+        {
+                const uint64_t coldTicks = m_streamingSettings.coldChunkTicks;
+
+                for(auto c = m_loadedChunks.begin(); c != m_loadedChunks.end(); ++c)
+                {
+                        Chunk& chunk = c->second;
+
+                        auto next = std::next(c);
+                        const bool prevTicking = c != m_loadedChunks.begin() && std::prev(c)->first == c->first - 1 && std::prev(c)->second.tier == ChunkTier::TICKING;
+                        const bool nextTicking = next != m_loadedChunks.end() && next->first == c->first + 1 && next->second.tier == ChunkTier::TICKING;
+
+                        if(chunk.tier == ChunkTier::TICKING || prevTicking || nextTicking)
+                        {
+                                if(chunk.isCompressed())
+                                        decompressChunk(chunk);
+
+                                continue;
+                        }
+
+                        if(chunk.isCompressed() || coldTicks == 0 || m_currTick - chunk.lastAccessTick < coldTicks)
+                                continue;
+
+                        const size_t uncompressedBytes = chunk.getMemoryUsage();
+                        chunk.compress();
+
+                        // Chunks full of different blocks may not get smaller
+                        const size_t compressedBytes = chunk.getMemoryUsage();
+                        if(compressedBytes >= uncompressedBytes)
+                        {
+                                chunk.decompress();
+                                chunk.lastAccessTick = m_currTick;
+                                continue;
+                        }
+
+                        m_compressionStats.savedBytes += uncompressedBytes - compressedBytes;
+                        ++m_compressionStats.compressions;
+                }
+        }
+
+
+        // Decompresses a chunk that is being accessed
+        // @c: the compressed chunk
+        void GameWorld::decompressChunk(Chunk& c)
+        {
+                const auto start = std::chrono::steady_clock::now();
+                const size_t compressedBytes = c.getMemoryUsage();
+
+                c.decompress();
+                c.lastAccessTick = m_currTick;
+
+                const size_t uncompressedBytes = c.getMemoryUsage();
+                m_compressionStats.savedBytes -= std::min(m_compressionStats.savedBytes, uncompressedBytes - compressedBytes);
+                m_compressionStats.decompressionTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                ++m_compressionStats.decompressions;
+        }
+
+
+        // Attempts to find the chunk that contains the given entity
+        // @e: the entity for which we want to find the chunk
+        // @returns: on success a pointer to a chunk, nullptr otherwise
+        Chunk* GameWorld::getEntityChunk(EntityHandle e)
+        {
+                auto c = m_loadedChunks.find(getEntityChunkId(e));
+                return c == m_loadedChunks.end() ? nullptr : &(c->second);
+        }
+
+
+        // Utility function used to determine all the loaded chunks that are visible from the given camera, the chunks are
+        // returned as snapshots so compressed chunks stay compressed
+        // @camera: defines the point of view of the world
+        // @returns: the snapshots of the visible chunks, ordered by chunk id (the list is allocated from the frame arena, it must
+        //           not be kept after the current frame)
+        FrameVector<std::shared_ptr<const ChunkSnapshot>> GameWorld::getVisibleChunkSnapshots(const Camera& camera)
+        {
+                FrameVector<std::shared_ptr<const ChunkSnapshot>> snapshots;
+                for(auto& c : m_loadedChunks)
+                {
+                        if(doesRectsIntersect(camera.getPos().x, camera.getPos().y, (float) camera.getWidth(), (float) camera.getHeight(),
+                                                c.second.getPos().x, c.second.getPos().y, (float) Chunk::width, (float) Chunk::height))
+                                snapshots.push_back(c.second.takeSnapshot(m_currTick));
+                }
+
+                return snapshots;
+        }
+
+
+        // Returns a snapshot of the blocks of a loaded chunk, the snapshot can be read by any thread while the world is updated
+        // @id: id of the chunk
+        // @returns: the snapshot, nullptr if the chunk is not loaded
+        std::shared_ptr<const ChunkSnapshot> GameWorld::getChunkSnapshot(int id)
+        {
+                auto c = m_loadedChunks.find(id);
+                return c == m_loadedChunks.end() ? nullptr : c->second.takeSnapshot(m_currTick);
+        }
+
+
+        // Loads/unloads chunks and moves them between the tiers according to the positions of the players in the game world
+        void GameWorld::recomputeLoadedChunks()
+        {
+                // Entities must be in the right chunk before the chunks get unloaded (they are saved with their chunk)
+                migrateEntities();
+
+                // Chunks are kept a little farther than where they are loaded (unload radius), so a player that goes back
+                // and forth on the border of a chunk does not load and unload the same chunks over and over
+                computeIntervals(m_streamingSettings.simulationRadius, m_tickIntervals);
+                computeIntervals(m_streamingSettings.loadRadius, m_loadIntervals);
+                computeIntervals(m_streamingSettings.unloadRadius, m_keepIntervals);
+
+                // Both the intervals and the loaded chunks are sorted by id, so they are walked together: chunks outside
+                // of the keep intervals are unloaded and missing chunks inside the load intervals (that are always inside
+                // a keep interval) are loaded
+                auto c = m_loadedChunks.begin();
+                size_t nextLoad = 0;
+
+                for(const glm::ivec2& keep : m_keepIntervals)
+                {
+                        while(c != m_loadedChunks.end() && c->first < keep.x)
+                                c = unloadChunk(c);
+
+                        for(; nextLoad < m_loadIntervals.size() && m_loadIntervals[nextLoad].y <= keep.y; ++nextLoad)
+                        {
+                                for(int id = m_loadIntervals[nextLoad].x; id <= m_loadIntervals[nextLoad].y; ++id)
+                                {
+                                        while(c != m_loadedChunks.end() && c->first < id)
+                                                ++c;
+
+                                        if(c != m_loadedChunks.end() && c->first == id)
+                                                ++c;
+                                        else
+                                                loadChunk(id);          // Inserted before c, so c is still the next chunk to check
+                                }
+                        }
+
+                        while(c != m_loadedChunks.end() && c->first <= keep.y)
+                                ++c;
+                }
+
+                while(c != m_loadedChunks.end())
+                        c = unloadChunk(c);
+
+                updateChunkTiers();
+
+                // Forget the unloads that are too old to count as thrashing
+                m_recentUnloads.erase(std::remove_if(m_recentUnloads.begin(), m_recentUnloads.end(),
+                        [this](const std::pair<int, uint64_t>& u) { return m_currTick - u.second >= CHUNK_THRASH_WINDOW_TICKS; }), m_recentUnloads.end());
+        }
+
+
+        // Thaws the loaded chunks inside the tick intervals and freezes the other ones (both the chunks and the intervals
+        // are walked in order of id)
+        void GameWorld::updateChunkTiers()
+        {
+                size_t t = 0;
+                for(auto& c : m_loadedChunks)
+                {
+                        while(t < m_tickIntervals.size() && m_tickIntervals[t].y < c.first)
+                                ++t;
+
+                        if(t < m_tickIntervals.size() && m_tickIntervals[t].x <= c.first)
+                                thawChunk(c.second);
+                        else
+                                freezeChunk(c.second);
+                }
+        }
+
+
+        // Computes the merged ranges of chunks that are within the given distance from the players (and from the chunks that
+        // they are going to reach)
+        // @radius: distance from the players measured in chunks
+        // @intervals: vector in which the ranges are written (x is the first id, y the last one), sorted by id
+        void GameWorld::computeIntervals(int radius, std::vector<glm::ivec2>& intervals) const
+        {
+                intervals.clear();
+                for(const glm::ivec2& range : m_playersChunkRanges)
+                        intervals.push_back(glm::ivec2(range.x - radius, range.y + radius));
+
+                mergeIntervals(intervals);
+        }
+
+
+        // Sorts the given intervals and merges the ones that overlap or touch each other
+        // @intervals: intervals of chunk ids (x is the first id, y the last one), they are replaced by the merged ones
+        void GameWorld::mergeIntervals(std::vector<glm::ivec2>& intervals)
+        {
+                if(intervals.empty())
+                        return;
+
+                std::sort(intervals.begin(), intervals.end(), [](const glm::ivec2& a, const glm::ivec2& b) { return a.x < b.x; });
+
+                size_t last = 0;
+                for(size_t i = 1; i < intervals.size(); ++i)
+                {
+                        if(intervals[i].x <= intervals[last].y + 1)
+                                intervals[last].y = std::max(intervals[last].y, intervals[i].y);
+                        else
+                                intervals[++last] = intervals[i];
+                }
+
+                intervals.resize(last + 1);
+        }
+
+
+        // Returns the range of chunks around which the chunks of a player are kept: the chunk of the player and the chunk that
+        // the player will reach in the prefetch time (at its current velocity), the radius of each tier is added to this range
+        // @player: the player
+        // @returns: the id of the first (x) and of the last (y) chunk of the range
+        glm::ivec2 GameWorld::getPlayerChunkRange(EntityHandle player) const
+        {
+                const int playerChunkId = getEntityChunkId(player);
+                const float prefetchX = m_entities.getPos(player).x + m_entities.getVelocity(player).x * m_streamingSettings.prefetchTime;
+                const int prefetchChunkId = (int) std::floor(prefetchX / (float) Chunk::width);
+
+                return glm::ivec2(std::min(playerChunkId, prefetchChunkId), std::max(playerChunkId, prefetchChunkId));
+        }
+
+
+        // Changes which chunks are kept in memory around the players (the change is applied in the next update)
+        // @settings: the new settings
+        // @returns: true on success, false if the settings are not valid
+        bool GameWorld::setChunkStreamingSettings(const ChunkStreamingSettings& settings)
+        {
+                if(settings.simulationRadius < 0 || settings.loadRadius < std::max(settings.simulationRadius, 1) ||
+                        settings.unloadRadius < settings.loadRadius || settings.prefetchTime < 0.0f)
+                {
+                        logWarn("GameWorld::setChunkStreamingSettings() failed, the radii must be in increasing order (simulation, load, "
+                                "unload), the load radius must be at least 1 and the prefetch time cannot be negative!");
+                        return false;
+                }
+
+                m_streamingSettings = settings;
+                m_chunkCache.setCompression(settings.compressCache);
+                m_chunkCache.setBudget(*this, settings.cacheBudget);
+                m_playersChunkRanges.clear();                    // Forces the recomputation of the loaded chunks
+                return true;
+        }
+
+
+        // Writes the world data in the given file
+        // @file: output file stream in which world data will be written
+        // @returns: true if serialization is successfull, false otherwise
+        bool GameWorld::serialize(std::ofstream& file)
+        {
+                if(!file.good())
+                {
+                        logError("GameWorld::serialize() failed, the given file stream is broken!");
+                        return false;
+                }
+
+                bool res = true;
+
+                // First we save the world seed
+                file << m_worldSeed << '\n';
+
+                // Then the day duration and the current day time
+                file << m_dayDuration << ' ' << m_dayTime << '\n';
+
+                // Then data about all players in the game world
+                file << m_players.size() << '\n';
+
+                res = file.good();
+
+                for(auto p = m_players.begin(); p != m_players.end() && res != false; ++p)
+                        res = m_entities.getEntity(*p).serialize(file);
+
+                // Then save all the chunks in memory (with the ticks that are pending in them), falling blocks are saved in
+                // the position in which they would land. Frozen and cached chunks already keep their ticks and entities, the
+                // entities parked for chunks that are not loaded are moved in their chunks (in the cache)
+                dropColumns(0, true);
+                migrateEntities();
+                storeParkedEntities();
+
+                for(auto c = m_loadedChunks.begin(); c != m_loadedChunks.end() && res != false; ++c)
+                {
+                        c->second.journalSeq = m_blockJournal.getNextSeq();
+                        const bool isTicking = c->second.tier == ChunkTier::TICKING;
+                        if(isTicking)
+                        {
+                                storeChunkTicks(c->second);
+                                storeChunkEntities(c->second);
+                        }
+
+                        res = WorldLoader::saveChunk(m_pathToWorldDir, c->second);
+                        if(isTicking)
+                        {
+                                c->second.scheduledTicks.clear();
+                                c->second.entities.clear();
+                        }
+                }
+
+                if(res)
+                        res = m_chunkCache.save(*this);
+
+                return res;
+        }
+
+
+        // Reads world data from the given file
+        // @file: input file stream from which world data will be read
+        // @returns: true if deserialization is successfull, false otherwise
+        bool GameWorld::deserialize(std::ifstream& file)
+        {
+                if(!file.good())
+                {
+                        logError("GameWorld::deserialize() failed, the given file stream is broken!");
+                        return false;
+                }
+
+                // Declare temporary variables to hold the deserialized data
+                unsigned seed;
+                size_t dayDuration;
+                float dayTime;
+                size_t playersNum;
+                std::vector<Entity> players;
 
                 file >> seed;                                   // Read world seed
                 file >> dayDuration;                            // Read duration of one day in the world
@@ -484,11 +1554,17 @@ namespace mc2d {
                 m_worldSeed = seed;
                 m_dayDuration = dayDuration;
                 m_dayTime = dayTime;
-                m_players = std::move(players);
+
+                for(EntityHandle p : m_players)
+                        m_entities.destroy(p);
+
+                m_players.clear();
+                for(const Entity& p : players)
+                        addPlayer(p);
 
                 // Load all chunks near players (for each player the chunks
                 // adjacent to the one in which the player currently is must be loaded)
-                for(auto& p : m_players)
+                for(EntityHandle p : m_players)
                 {
                         int playerChunkId = getEntityChunkId(p);
                         loadChunk(playerChunkId - 1);
@@ -500,8 +1576,99 @@ namespace mc2d {
         }
 
 
-        // Loads the chunk with given id and adds it to the loaded chunks, the chunk gets loaded from file system if an 
-        // associated chunk file exists, it is generated from scratch otherwise.
+        // Changes the directory in which the world data is stored, the block journal is written entirely in the new directory
+        // @path: path to the directory
+        void GameWorld::setWorldSaveDirectory(std::filesystem::path path)
+        {
+                if(path != m_pathToWorldDir)
+                        m_blockJournal.setNeedsRewrite();
+
+                m_pathToWorldDir = path;
+        }
+
+
+        // Writes all the chunks that are not loaded and not written yet: the entities parked for them, the cached chunks and
+        // the chunks waiting in the ChunkWriter (it waits until they are all on disk)
+        // @returns: true if all the chunks have been written, false otherwise
+        bool GameWorld::flushChunkWrites()
+        {
+                storeParkedEntities();
+                m_chunkCache.flush(*this);
+                return m_chunkWriter.flush();
+        }
+
+
+        // Moves the entities parked for the chunks that are not loaded in their chunks, which are put in the chunk cache (the
+        // chunks are taken from the ChunkWriter, loaded or generated if they are not cached). It must be called before the world
+        // is saved by another process, which would write the parked entities that this process keeps
+        void GameWorld::storeParkedEntities()
+        {
+                for(auto& parked : m_parkedEntities)
+                {
+                        Chunk c;
+                        if(!m_chunkCache.take(parked.first, c) && !m_chunkWriter.take(m_pathToWorldDir, parked.first, c))
+                        {
+                                if(!WorldLoader::loadChunk(m_pathToWorldDir, parked.first, c))
+                                {
+                                        c = WorldGenerator::generateRandomChunk(m_worldSeed + parked.first);
+                                        c.id = parked.first;
+                                }
+
+                                m_blockJournal.replay(c);
+                        }
+
+                        c.entities.insert(c.entities.end(), parked.second.begin(), parked.second.end());
+                        c.journalSeq = m_blockJournal.getNextSeq();
+                        c.tier = ChunkTier::CACHED;
+                        m_chunkCache.insert(*this, std::move(c));
+                }
+
+                m_parkedEntities.clear();
+        }
+
+
+        // Hands the block edits made since the last call over to the ChunkWriter, which appends them to the journal of the world
+        // (autosave), if the game crashes they are replayed when the world gets loaded again. The journal file is written by
+        // the ChunkWriter thread, the failure of a write is reported by the next call (that rewrites the whole journal)
+        // @returns: false if the last journal write failed (or if the world has no directory), true otherwise
+        bool GameWorld::syncBlockJournal()
+        {
+                bool res = m_chunkWriter.checkJournalWrites();
+                if(!res)
+                        m_blockJournal.setNeedsRewrite();
+
+                JournalBatch batch;
+                if(!m_blockJournal.takeNewRecords(batch))
+                        return res;
+
+                if(m_pathToWorldDir.empty())
+                {
+                        logError("GameWorld::syncBlockJournal() failed, the world has no directory in which the journal can be saved!");
+                        m_blockJournal.setNeedsRewrite();
+                        return false;
+                }
+
+                m_chunkWriter.writeJournal(m_pathToWorldDir, std::move(batch));
+                return res;
+        }
+
+
+        // Drops from the block journal the edits contained in the files written by a save of the whole world (compaction), the
+        // journal file gets rewritten by the ChunkWriter thread
+        // @savedSeq: sequence number of the next edit in the journal when the save has been started
+        // @returns: false if the last journal write failed, true otherwise
+        bool GameWorld::compactBlockJournal(uint64_t savedSeq)
+        {
+                // The chunks that were waiting to be written are not part of the save, the rewritten journal is queued after
+                // them so their edits are dropped from the file only once their files are complete
+                m_blockJournal.compact(savedSeq);
+                return syncBlockJournal();
+        }
+
+
+        // Loads the chunk with given id and adds it to the loaded chunks (frozen), the chunk is taken from the cached chunks
+        // (or from the chunks waiting to be written) if it is there, otherwise it gets loaded from file system if an associated
+        // chunk file exists, it is generated from scratch otherwise.
         // If a chunk with the given id is already loaded in the world then nothing happens.
         // @id: id associated to the chunk that needs to be loaded
         void GameWorld::loadChunk(int id)
@@ -511,18 +1678,61 @@ namespace mc2d {
 
                 Chunk c;
 
-                // Load chunk data from file, if file does not exists then generate a new random chunk
-                if(!WorldLoader::loadChunk(m_pathToWorldDir, id, c))
+                // Load chunk data from file (if it is not in memory), if file does not exists then generate a new random chunk,
+                // the edits that are not in the file are replayed from the block journal
+                if(!m_chunkCache.take(id, c) && !m_chunkWriter.take(m_pathToWorldDir, id, c))
+                {
+                        if(!WorldLoader::loadChunk(m_pathToWorldDir, id, c))
+                        {
+                                c = WorldGenerator::generateRandomChunk(m_worldSeed + id);
+                                c.id = id;
+                        }
+
+                        m_blockJournal.replay(c);
+                }
+
+                // Reuse the node of a chunk unloaded before (if any), so that loading a chunk does not allocate it
+                auto newChunk = m_loadedChunks.end();
+                if(m_freeChunkNodes.empty())
+                {
+                        newChunk = m_loadedChunks.insert( { id, std::move(c) } ).first;
+                }
+                else
+                {
+                        auto node = std::move(m_freeChunkNodes.back());
+                        m_freeChunkNodes.pop_back();
+
+                        node.key() = id;
+                        node.mapped() = std::move(c);
+                        newChunk = m_loadedChunks.insert(std::move(node)).position;
+                }
+
+                // The entities moved in the chunk while it was not loaded enter it now (they start ticking with it)
+                auto parked = m_parkedEntities.find(id);
+                if(parked != m_parkedEntities.end())
                 {
-                        c = WorldGenerator::generateRandomChunk(m_worldSeed + id);
-                        c.id = id;
+                        std::vector<Entity>& entities = newChunk->second.entities;
+                        entities.insert(entities.end(), parked->second.begin(), parked->second.end());
+                        m_parkedEntities.erase(parked);
                 }
 
-                m_loadedChunks.insert( { id, std::move(c) } );
+                initLoadedChunk(newChunk->second);
+
+                ++m_streamingStats.loads;
+                auto unload = std::find_if(m_recentUnloads.begin(), m_recentUnloads.end(), [id](const std::pair<int, uint64_t>& u) { return u.first == id; });
+                if(unload != m_recentUnloads.end())
+                {
+                        if(m_currTick - unload->second < CHUNK_THRASH_WINDOW_TICKS)
+                                ++m_streamingStats.thrashLoads;
+
+                        *unload = m_recentUnloads.back();
+                        m_recentUnloads.pop_back();
+                }
         }
 
 
-        // Unloads the given chunk (saves it to a file and removes it from the currently loaded ones)
+        // Unloads the given chunk (removes it from the currently loaded ones and moves it in the chunk cache, it will be
+        // saved to a file when it gets evicted from the cache)
         // @c: iterator pointing to the chunk that must be unloaded
         // @returns: iterator pointing to the chunk after the given one
         std::map<int, Chunk>::iterator GameWorld::unloadChunk(std::map<int, Chunk>::iterator& c)
@@ -530,8 +1740,193 @@ namespace mc2d {
                 if(c == m_loadedChunks.end())
                         return m_loadedChunks.end();
 
-                WorldLoader::saveChunk(m_pathToWorldDir, c->second);
-                return m_loadedChunks.erase(c);
+                dropColumns(c->first, false);
+                freezeChunk(c->second);
+
+                // Data computed when the chunk gets loaded is not kept in the cache
+                Chunk& chunk = c->second;
+                if(chunk.isCompressed())
+                        decompressChunk(chunk);
+
+                ChunkBufferPool::release(chunk.skyLight);
+                ChunkBufferPool::release(chunk.blockLight);
+                chunk.collidableRows.clear();
+                chunk.invalidateSnapshot();
+                chunk.journalSeq = m_blockJournal.getNextSeq();
+                chunk.tier = ChunkTier::CACHED;
+                m_fluidSimulator.onChunkTierChanged(chunk);
+                m_chunkCache.insert(*this, std::move(chunk));
+
+                ++m_streamingStats.unloads;
+                m_recentUnloads.emplace_back(c->first, m_currTick);
+
+                // The node of the chunk is kept to be reused by the next chunk loaded
+                auto next = std::next(c);
+                m_freeChunkNodes.push_back(m_loadedChunks.extract(c));
+                return next;
+        }
+
+
+        // Initializes the data of a chunk that has just been added to the loaded chunks (light, fluids and blocks summary), the
+        // chunk is frozen (its pending ticks and entities are activated by thawChunk())
+        // @c: the chunk that has been loaded
+        void GameWorld::initLoadedChunk(Chunk& c)
+        {
+                c.tier = ChunkTier::FROZEN;
+
+                c.randomTickBlocksNum = 0;
+                for(BlockType block : c.blocks)
+                        c.randomTickBlocksNum += WorldEncyclopedia::getBlockProperties(block).randomTicks;
+
+                c.computeCollidableRows();
+
+                m_lightEngine.computeChunkLight(*this, c);
+                m_fluidSimulator.onChunkLoaded(c);
+        }
+
+
+        // Makes a frozen chunk tick: its pending ticks go back to the tick scheduler and its entities to the entity store
+        // @c: the chunk (nothing happens if it is already ticking)
+        void GameWorld::thawChunk(Chunk& c)
+        {
+                if(c.tier != ChunkTier::FROZEN)
+                        return;
+
+                if(c.isCompressed())
+                        decompressChunk(c);
+
+                for(const ScheduledTick& t : c.scheduledTicks)
+                        m_tickScheduler.schedule((c.id * Chunk::width) + t.x, t.y, t.block, t.delay);
+
+                c.scheduledTicks.clear();
+
+                c.entityHandles.clear();
+                for(const Entity& e : c.entities)
+                {
+                        EntityHandle h = m_entities.create(e);
+                        if(h != INVALID_ENTITY_HANDLE)
+                                c.entityHandles.push_back(h);
+                }
+
+                c.entities.clear();
+                c.tier = ChunkTier::TICKING;
+                m_fluidSimulator.onChunkTierChanged(c);
+        }
+
+
+        // Freezes a ticking chunk: its pending ticks (with their remaining delay) and its entities are parked in the chunk,
+        // so they stop until the chunk ticks again
+        // @c: the chunk (nothing happens if it is not ticking)
+        void GameWorld::freezeChunk(Chunk& c)
+        {
+                if(c.tier != ChunkTier::TICKING)
+                        return;
+
+                storeChunkTicks(c);
+                m_tickScheduler.removeChunkTicks(c.id);
+
+                storeChunkEntities(c);
+                for(EntityHandle e : c.entityHandles)
+                        m_entities.destroy(e);
+
+                c.entityHandles.clear();
+                c.tier = ChunkTier::FROZEN;
+        }
+
+
+        // Copies the ticks pending in the given chunk into its scheduledTicks vector (so that they can be saved with the chunk)
+        // @c: the chunk whose pending ticks must be copied
+        void GameWorld::storeChunkTicks(Chunk& c)
+        {
+                c.scheduledTicks.clear();
+                m_tickScheduler.getChunkTicks(c.id, c.scheduledTicks);
+
+                for(ScheduledTick& t : c.scheduledTicks)
+                        t.x -= c.id * Chunk::width;
+        }
+
+
+        // Moves the entities that have crossed the border of their chunk to the chunk that now contains them, all the entities
+        // that moved since the last call are migrated in a single batch
+        void GameWorld::migrateEntities()
+        {
+                m_entityMigrations.clear();
+
+                // Collect the entities that have left their chunk (and drop the handles of the entities that have been destroyed)
+                for(auto& c : m_loadedChunks)
+                {
+                        std::vector<EntityHandle>& handles = c.second.entityHandles;
+                        for(size_t i = 0; i < handles.size(); )
+                        {
+                                const bool isValid = m_entities.isValid(handles[i]);
+                                if(isValid && getEntityChunkId(handles[i]) == c.first)
+                                {
+                                        ++i;
+                                        continue;
+                                }
+
+                                if(isValid)
+                                        m_entityMigrations.push_back( { getEntityChunkId(handles[i]), handles[i] } );
+
+                                handles[i] = handles.back();
+                                handles.pop_back();
+                        }
+                }
+
+                applyEntityMigrations();
+        }
+
+
+        // Adds the entities in m_entityMigrations to their new chunks (they must have been removed from their old ones already),
+        // the entities that reach a chunk that is not ticking are parked
+        void GameWorld::applyEntityMigrations()
+        {
+                if(m_entityMigrations.empty())
+                        return;
+
+                // Add the entities to their new chunks, looking up each chunk only once
+                std::sort(m_entityMigrations.begin(), m_entityMigrations.end(),
+                        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+                for(size_t i = 0; i < m_entityMigrations.size(); )
+                {
+                        const int chunkId = m_entityMigrations[i].first;
+                        auto c = m_loadedChunks.find(chunkId);
+
+                        // Entities cannot walk into chunks that are not loaded (they are solid), but they can be moved there
+                        // with setPos(), in that case they are parked until their chunk gets loaded (see loadChunk()).
+                        // Entities that walk into a frozen chunk are parked in it
+                        std::vector<Entity>* parked = nullptr;
+                        if(c == m_loadedChunks.end())
+                                parked = &m_parkedEntities[chunkId];
+                        else if(c->second.tier != ChunkTier::TICKING)
+                                parked = &c->second.entities;
+
+                        for(; i < m_entityMigrations.size() && m_entityMigrations[i].first == chunkId; ++i)
+                        {
+                                EntityHandle e = m_entityMigrations[i].second;
+                                if(parked == nullptr)
+                                {
+                                        c->second.entityHandles.push_back(e);
+                                        continue;
+                                }
+
+                                parked->push_back(m_entities.getEntity(e));
+                                m_entities.destroy(e);
+                        }
+                }
+        }
+
+
+        // Copies the data of the entities contained in the given chunk into its entities vector (so that they can be saved with the chunk)
+        // @c: the chunk whose entities must be copied
+        void GameWorld::storeChunkEntities(Chunk& c)
+        {
+                c.entities.clear();
+                c.entities.reserve(c.entityHandles.size());
+
+                for(EntityHandle e : c.entityHandles)
+                        c.entities.push_back(m_entities.getEntity(e));
         }
 
 
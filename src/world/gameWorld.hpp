@@ -6,6 +6,13 @@
 // The Chunk struct is used to keep track of all the blocks that makes up a portion of the game world and all the entities
 // (aside from players) that are contained in it.
 //
+// Chunks are kept in tiers depending on their distance from the players (see ChunkStreamingSettings): the nearest ones are
+// ticking (blocks and entities are simulated), the ones after them are loaded but frozen (they are drawn and can be
+// edited but time does not pass in them) and the unloaded ones are cached (kept in memory, within a memory budget, so
+// they can be loaded again without reading a file, see ChunkCache). Chunks move between tiers without being saved or
+// loaded from disk. Frozen chunks that are not accessed for a while are compressed in place and they are decompressed
+// as soon as they are accessed again (through findChunk()).
+//
 // The game world is structured as a sequence of chunks, the chunk in which the player spawn is the root chunk and
 // has the id 0; chunks to the left of the root chunk have negative ids while chunks to the right have positive ids.
 // The coordinate system used in the game world is a cartesian system which has the origin positioned in the bottom left
@@ -17,26 +24,58 @@
 
 #include <vector>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <string>
 #include <filesystem>
 #include <cstdint>
+#include <climits>
 #include <cmath>
+#include <algorithm>
+#include <random>
+#include <chrono>
 #include <glm/vec2.hpp>
 
 #include "log.hpp"
 #include "utility.hpp"
+#include "frameArena.hpp"
 #include "blockTypes.hpp"
 #include "structure.hpp"
 #include "entity.hpp"
+#include "entityStore.hpp"
+#include "lightEngine.hpp"
+#include "fluidSimulator.hpp"
+#include "tickScheduler.hpp"
+#include "randomTicker.hpp"
+#include "explosionSimulator.hpp"
+#include "entityCollider.hpp"
+#include "spatialHash.hpp"
+#include "taskPool.hpp"
+#include "chunkCache.hpp"
+#include "chunkWriter.hpp"
+#include "blockJournal.hpp"
+#include "chunkBufferPool.hpp"
 
 namespace mc2d {
 
         enum class BiomeType : uint32_t;
+        enum class TreeType : uint32_t;
         class WorldGenerator;
         class WorldLoader;
         class Camera;
 
 
+        // Tiers in which the chunks are kept (from the nearest to the players to the farthest)
+        enum class ChunkTier : uint8_t {
+                TICKING,                                        // Loaded and simulated (blocks get ticks, entities move)
+                FROZEN,                                         // Loaded but not simulated, its entities and pending ticks are parked in the chunk
+                CACHED                                          // Unloaded but kept in memory (without the data computed when it gets loaded)
+        };
+
+
+        struct ChunkSnapshot;
+
+
         struct Chunk {
                 static constexpr uint8_t width = 18;            // Width of the chunk measured in blocks, never set below 8!
                 static constexpr uint8_t height = 18;           // Height of the chunk measured in blocks, never set below 8!
@@ -44,26 +83,168 @@ namespace mc2d {
                 int                     id;                     // Uniquely identifies the chunk in the game world (is negative for left chunks, positive for the right ones)
                 BiomeType               biome;
                 std::vector<BlockType>  blocks;                 // Keeps track of all the blocks in the chunk
-                std::vector<Entity>     entities;               // Keeps track of all the entities that are contained in the chunk
+                std::vector<EntityHandle> entityHandles;        // Keeps track of all the entities that are contained in the chunk (their data is in the world entity store)
+                std::vector<Entity>     entities;               // Data of the entities contained in the chunk, filled only while the chunk is saved, loaded or not ticking
                 std::vector<Structure>  interChunkStructures;   // Keeps track of the structures in the chunk that are partially positioned in a neighbor chunk and still needs to be spawned in the neighbor
+                std::vector<uint8_t>    skyLight;               // Sky light level of each block in the chunk (computed when the chunk gets loaded, never saved)
+                std::vector<uint8_t>    blockLight;             // Light level emitted by light sources for each block in the chunk (computed when the chunk gets loaded, never saved)
+                std::vector<uint8_t>    fluidLevels;            // Amount of fluid contained in each block of the chunk (zero for blocks that are not fluids)
+                std::vector<ScheduledTick> scheduledTicks;      // Ticks pending for the blocks of the chunk (x is relative to the chunk), filled only while the chunk is saved, loaded or not ticking
+                uint32_t                randomTickBlocksNum = 0; // Number of blocks in the chunk that react to random ticks (computed when the chunk gets loaded)
+                std::vector<uint32_t>   collidableRows;         // For each row of blocks (indexed by y) a mask of the collidable blocks, bit i is set if the block in column i is collidable (computed when the chunk gets loaded)
+                ChunkTier               tier = ChunkTier::FROZEN;
+                std::vector<uint8_t>    packedData;             // Blocks, fluid levels and light levels encoded as runs of equal values, not empty only while the chunk is compressed (the arrays are empty then)
+                uint64_t                lastAccessTick = 0;     // Last tick in which the chunk has been edited or decompressed (used to find the cold chunks)
+                uint64_t                journalSeq = 0;         // Sequence number of the first edit in the block journal that is not contained in the chunk (set when the chunk gets unloaded or saved)
+                std::shared_ptr<const ChunkSnapshot> snapshot;  // Last snapshot taken, shared with the readers until the chunk gets edited (see takeSnapshot())
 
                 // Returns the coordinates (in world space) of the top left corner of the chunk
                 inline glm::vec2        getPos() const                { return glm::vec2( (float) (id * Chunk::width) * BLOCK_WIDTH, (float) Chunk::height * BLOCK_HEIGHT); }
 
+                // Returns the index (relative to the blocks vector) of the block at the given world coordinates (that must be inside the chunk)
+                inline size_t           getBlockIndex(int x, int y) const       { return ((size_t) (Chunk::height - 1 - y) * Chunk::width) + (size_t) (x - id * Chunk::width); }
+
+                // Returns the id of the chunk that contains the blocks with the given x coordinate (in world space)
+                static inline int       getIdFromBlockX(int x)                  { return x >= 0 ? x / Chunk::width : ((x + 1) / Chunk::width) - 1; }
+
+
+                // Returns true if the blocks of the chunk are compressed (see compress())
+                inline bool             isCompressed() const                    { return !packedData.empty(); }
+
+                BlockType               getPackedBlock(size_t index) const;
+
+                void                    computeCollidableRows();
+                void                    updateCollidableBit(int x, int y);
+                void                    compress();
+                void                    decompress();
+                void                    releaseBuffers();
+                std::shared_ptr<const ChunkSnapshot> takeSnapshot(uint64_t tick);
+
+                // Drops the last snapshot of the chunk (must be called each time its blocks, fluid or light levels change), the
+                // readers that hold it can keep using it
+                inline void             invalidateSnapshot()                    { snapshot.reset(); }
+                size_t                  getMemoryUsage() const;
 
                 bool                    serialize(std::ofstream& file) const;
                 bool                    deserialize(std::ifstream& file);
         };
 
+        static_assert(Chunk::width <= 32, "The collidable blocks of one row of a chunk must fit in a 32 bit mask");
+
+
+        // Immutable copy of the blocks (with the fluid and the light levels) of a chunk, it is shared by all the readers of the
+        // chunk (the WorldMesher, savers, map exporters, ...) without locks while the simulation keeps editing the chunk. A chunk
+        // keeps its last snapshot until it gets edited, so taking many snapshots of a chunk that does not change copies its
+        // blocks once. Snapshots can be taken from compressed chunks without decompressing them
+        struct ChunkSnapshot {
+                int                     id;
+                BiomeType               biome;
+                std::vector<BlockType>  blocks;                 // Same layout of Chunk::blocks
+                std::vector<uint8_t>    fluidLevels;
+                std::vector<uint8_t>    skyLight;               // Empty if the light of the chunk has not been computed
+                std::vector<uint8_t>    blockLight;
+                uint64_t                tick;                   // Tick in which the snapshot has been taken
+
+                // Returns the coordinates (in world space) of the top left corner of the chunk
+                inline glm::vec2        getPos() const                          { return glm::vec2( (float) (id * Chunk::width) * BLOCK_WIDTH, (float) Chunk::height * BLOCK_HEIGHT); }
+
+                // Returns the block at the given world coordinates (that must be inside the chunk)
+                inline BlockType        getBlock(int x, int y) const            { return blocks[((size_t) (Chunk::height - 1 - y) * Chunk::width) + (size_t) (x - id * Chunk::width)]; }
+        };
+
+
+        // Defines a column of adjacent blocks (affected by gravity) that are falling together, the blocks are
+        // removed from their chunk while falling and are written back in one single batch when the column lands
+        struct FallingColumn {
+                int                     x;                      // X coordinate of the column in world space
+                float                   bottomY;                // Y coordinate (in world space) of the bottom of the column
+                float                   velocity;               // Falling speed measured in blocks per tick
+                std::vector<BlockType>  blocks;                 // Blocks that makes up the column (from the bottom to the top)
+        };
+
 
         // Default duration value of one day (in milliseconds) in a game world (300'000 ms = 5 minutes)
         constexpr size_t DEFAULT_DAY_DURATION = 300'000u;
 
+        // Minimum value by which sky light gets scaled (reached at midnight)
+        constexpr float MIN_SKY_LIGHT_FACTOR = 0.15f;
+
+        // Duration of one world tick (in milliseconds), block simulation (fluids, ...) advances by one step each tick
+        constexpr float WORLD_TICK_DURATION = 50.0f;
+
+        // Number of simulation steps in one world tick, the entities are updated once per step (so they move smoothly) while
+        // the blocks are updated once per tick
+        constexpr uint32_t STEPS_PER_WORLD_TICK = 3;
+
+        // Duration of one simulation step (in milliseconds), each update of the world advances it by one step
+        constexpr float SIMULATION_STEP_DURATION = WORLD_TICK_DURATION / STEPS_PER_WORLD_TICK;
+
+        // Acceleration (in blocks per tick squared) and maximum speed (in blocks per tick) of the falling blocks
+        constexpr float FALLING_BLOCK_GRAVITY = 0.04f;
+        constexpr float FALLING_BLOCK_MAX_VELOCITY = 1.0f;
+
+        // Number of ticks (min and max) that a sapling needs to grow into a tree
+        constexpr uint64_t SAPLING_MIN_GROWTH_TICKS = 1200;
+        constexpr uint64_t SAPLING_MAX_GROWTH_TICKS = 2400;
+
+        // Number of ticks after which an active furnace goes out
+        constexpr uint64_t FURNACE_BURN_TICKS = 200;
+
+        // Number of ticks between the ignition of a TNT block and its explosion
+        constexpr uint64_t TNT_FUSE_TICKS = 80;
+
+        // A chunk loaded again within this number of ticks from its unload counts as thrashing (see ChunkStreamingStats)
+        constexpr uint64_t CHUNK_THRASH_WINDOW_TICKS = 200;
+
+
+        // Defines which chunks are kept in memory around the players and in which tier (distances are measured in chunks from the
+        // chunk of the player, each radius cannot be smaller than the previous one)
+        struct ChunkStreamingSettings {
+                int                     simulationRadius = 1;   // Chunks up to this distance from a player are ticking, the other loaded chunks are frozen
+                int                     loadRadius = 2;         // Chunks up to this distance from a player are loaded (never less than 1)
+                int                     unloadRadius = 3;       // Chunks are unloaded only when they are farther than this from all the players
+                size_t                  cacheBudget = DEFAULT_CHUNK_CACHE_BUDGET; // Memory used by the unloaded chunks kept in memory (in bytes), the least recent ones are written to disk
+                bool                    compressCache = true;   // If true the unloaded chunks are compressed while they are kept in memory
+                uint64_t                coldChunkTicks = 600;   // Frozen chunks that are not accessed for this number of ticks are compressed in place (zero disables it)
+                float                   prefetchTime = 1.0f;    // The chunks that a player will reach in this time (in seconds, at its current speed) are loaded in advance
+        };
+
+
+        // Counters of the chunks loaded and unloaded by the world
+        struct ChunkStreamingStats {
+                uint64_t                loads = 0;
+                uint64_t                unloads = 0;
+                uint64_t                thrashLoads = 0;        // Loads of chunks that had been unloaded less than CHUNK_THRASH_WINDOW_TICKS ago
+
+                // Returns the fraction of the loads that were caused by thrashing
+                inline float            getThrashRate() const   { return loads == 0 ? 0.0f : (float) thrashLoads / (float) loads; }
+        };
+
+
+
+        // Counters of the compression of the loaded chunks that are not accessed (cold chunks)
+        struct ChunkCompressionStats {
+                uint64_t                compressions = 0;
+                uint64_t                decompressions = 0;
+                size_t                  savedBytes = 0;         // Memory currently saved by the compressed chunks (in bytes)
+                uint64_t                decompressionTime = 0;  // Total time spent decompressing chunks on access (in nanoseconds)
+
+                // Returns the average time spent to decompress a chunk on access (in microseconds)
+                inline float            getAverageDecompressionTime() const     { return decompressions == 0 ? 0.0f : (float) decompressionTime / (float) decompressions / 1000.0f; }
+        };
+
+
 
         class GameWorld {
         public:
                 friend class WorldGenerator;
                 friend class WorldLoader;
+                friend class LightEngine;
+                friend class FluidSimulator;
+                friend class RandomTicker;
+                friend class ExplosionSimulator;
+                friend class EntityCollider;
+                friend class ChunkCache;
 
                 GameWorld();
                 GameWorld(GameWorld& otherWorld);
@@ -72,35 +253,94 @@ namespace mc2d {
 
                 GameWorld&                              operator = (GameWorld&& otherWorld);
 
-                void                                    update(float deltaTime);
+                void                                    update();
 
                 void                                    setBlock(float x, float y, BlockType newBlock);
+                void                                    applyBlockEdits(const std::vector<BlockEdit>& edits);
+                bool                                    igniteBlock(float x, float y);
+                EntityHandle                            addPlayer(const Entity& player);
+                EntityHandle                            addEntity(const Entity& entity);
                 inline void                             setHasChanged(bool changed)                             { m_hasChanged = changed; }
-                inline void                             setWorldSaveDirectory(std::filesystem::path path)       { m_pathToWorldDir = path; }
+                void                                    setWorldSaveDirectory(std::filesystem::path path);
                 inline void                             setDayDuration(size_t millis)                           { m_dayDuration = millis; }
                 void                                    setDayTime(size_t hours, size_t minutes);
+                bool                                    setChunkStreamingSettings(const ChunkStreamingSettings& settings);
+                inline void                             pauseChunkWrites(bool paused)                           { m_chunkCache.setEvictionPaused(*this, paused); }
+                bool                                    flushChunkWrites();
+                void                                    storeParkedEntities();
+                bool                                    syncBlockJournal();
+                bool                                    compactBlockJournal(uint64_t savedSeq);
 
                 BlockType                               getBlock(float x, float y) const;
                 inline bool                             hasChanged() const                                      { return m_hasChanged; }
                 inline unsigned                         getSeed() const                                         { return m_worldSeed; }
                 inline std::filesystem::path            getWorldSaveDirectory() const                           { return m_pathToWorldDir; }
                 inline size_t                           getDayDuration() const                                  { return m_dayDuration; }
+                inline uint64_t                         getCurrentTick() const                                  { return m_currTick; }
                 void                                    getDayTime(size_t& hours, size_t& minutes) const;
+                float                                   getSkyLightFactor() const;
 
-                inline Entity&                          getMainPlayer()                                         { return m_players[0]; }
-                inline std::vector<Entity>&             getPlayers()                                            { return m_players; }
+                inline EntityHandle                     getMainPlayer() const                                   { return m_players[0]; }
+                inline const std::vector<EntityHandle>& getPlayers() const                                      { return m_players; }
+                inline EntityStore&                     getEntities()                                           { return m_entities; }
+                inline const EntityStore&               getEntities() const                                     { return m_entities; }
+                inline FluidSimulator&                  getFluidSimulator()                                     { return m_fluidSimulator; }
+                inline const TickScheduler&             getTickScheduler() const                                { return m_tickScheduler; }
+                inline RandomTicker&                    getRandomTicker()                                       { return m_randomTicker; }
+                inline ExplosionSimulator&              getExplosionSimulator()                                 { return m_explosionSimulator; }
+                inline const std::vector<FallingColumn>& getFallingColumns() const                              { return m_fallingColumns; }
+                inline const SpatialHash&               getSpatialHash() const                                  { return m_spatialHash; }
+                inline TaskPool&                        getTaskPool()                                           { return m_taskPool; }
+                inline const ChunkStreamingSettings&    getChunkStreamingSettings() const                       { return m_streamingSettings; }
+                inline const ChunkStreamingStats&       getChunkStreamingStats() const                          { return m_streamingStats; }
                 
                 const std::map<int, Chunk>&             getLoadedChunks() const                                 { return m_loadedChunks; }
-                inline int                              getEntityChunkId(const Entity& e) const                 { return std::floor(e.getPos().x / (float) Chunk::width); }
-                Chunk*                                  getEntityChunk(const Entity& e);
-                std::vector<const Chunk*>               getVisibleChunks(const Camera& camera) const;
+                inline const ChunkCache&                getChunkCache() const                                   { return m_chunkCache; }
+                inline const ChunkWriter&               getChunkWriter() const                                  { return m_chunkWriter; }
+                inline const BlockJournal&              getBlockJournal() const                                 { return m_blockJournal; }
+                inline const ChunkCompressionStats&     getChunkCompressionStats() const                        { return m_compressionStats; }
+                inline int                              getEntityChunkId(EntityHandle e) const                  { return std::floor(m_entities.getPos(e).x / (float) Chunk::width); }
+                Chunk*                                  getEntityChunk(EntityHandle e);
+                FrameVector<std::shared_ptr<const ChunkSnapshot>> getVisibleChunkSnapshots(const Camera& camera);
+                std::shared_ptr<const ChunkSnapshot>    getChunkSnapshot(int id);
 
-                bool                                    serialize(std::ofstream& file) const;
+                bool                                    serialize(std::ofstream& file);
                 bool                                    deserialize(std::ifstream& file);
 
         private:
 
+                void                                    tick();
+                void                                    onScheduledTick(const ScheduledTick& t);
+                void                                    scheduleBlockTick(int x, int y, BlockType block);
+                void                                    scheduleTick(int x, int y, BlockType block, uint64_t delay);
+                void                                    cancelTick(int x, int y);
+                bool                                    isTickScheduled(int x, int y) const;
+                std::vector<ScheduledTick>*             findParkedTicks(int x);
+                void                                    growTree(int x, int y, TreeType type);
+
+                void                                    processGravityChecks();
+                void                                    updateFallingColumns();
+                void                                    landColumn(const FallingColumn& column, int bottomY);
+                void                                    dropColumns(int chunkId, bool allChunks);
+                bool                                    isSupportingBlock(int x, int y);
+
+                bool                                    placeBlock(int x, int y, BlockType newBlock);
+                Chunk*                                  findChunk(int x, int y);
+                const Chunk*                            peekChunk(int x, int y) const;
+                void                                    compressColdChunks();
+                void                                    decompressChunk(Chunk& c);
+                void                                    initLoadedChunk(Chunk& c);
+                void                                    thawChunk(Chunk& c);
+                void                                    freezeChunk(Chunk& c);
+                void                                    storeChunkTicks(Chunk& c);
+                void                                    storeChunkEntities(Chunk& c);
+                void                                    migrateEntities();
+                void                                    applyEntityMigrations();
+                void                                    computeIntervals(int radius, std::vector<glm::ivec2>& intervals) const;
+                static void                             mergeIntervals(std::vector<glm::ivec2>& intervals);
+                glm::ivec2                              getPlayerChunkRange(EntityHandle player) const;
                 void                                    recomputeLoadedChunks();
+                void                                    updateChunkTiers();
                 void                                    loadChunk(int id);
                 std::map<int, Chunk>::iterator          unloadChunk(std::map<int, Chunk>::iterator& c);
 
@@ -110,8 +350,38 @@ namespace mc2d {
                 std::filesystem::path   m_pathToWorldDir;       // Path to the directory in which world data is stored
                 size_t                  m_dayDuration;          // Duration of one day in milliseconds
                 float                   m_dayTime;              // The current time in the world in milliseconds (used to control the day-night cycle)
-                std::map<int, Chunk>    m_loadedChunks;         // Chunks currently in memory
-                std::vector<Entity>     m_players;              // Keeps track of all players in the game world
+                std::map<int, Chunk>    m_loadedChunks;         // Chunks currently loaded (ticking or frozen)
+                ChunkCache              m_chunkCache;           // Chunks unloaded recently that are still kept in memory
+                ChunkWriter             m_chunkWriter;          // Writes the chunks evicted from the cache on a background thread
+                BlockJournal            m_blockJournal;         // Block edits that may not be in the chunk files yet
+                EntityStore             m_entities;             // Data of all the entities in the game world (players and mobs in the loaded chunks)
+                std::vector<EntityHandle> m_players;            // Keeps track of all players in the game world
+                EntityCollider          m_entityCollider;       // Moves the entities and keeps them out of the collidable blocks
+                SpatialHash             m_spatialHash;          // Used to find the entities in a region of the world (rebuilt after each update of the entities)
+                std::unordered_map<int, std::vector<Entity>> m_parkedEntities; // Entities moved in chunks that are not loaded (by id of the chunk), they enter the chunk when it gets loaded
+                std::vector<ScheduledTick> m_dueTicks;          // Ticks that are due in the current world tick (reused by each tick)
+                std::vector<std::pair<int, EntityHandle>> m_entityMigrations; // Entities that are moving to another chunk (with the id of the new chunk), used while migrating
+                std::vector<glm::ivec2> m_playersChunkRanges;   // Chunk of each player and chunk that it is going to reach at the last check (used to detect when chunks must be loaded/unloaded)
+                ChunkStreamingSettings  m_streamingSettings;
+                ChunkStreamingStats     m_streamingStats;
+                ChunkCompressionStats   m_compressionStats;
+                std::vector<glm::ivec2> m_tickIntervals;        // Merged ranges of chunks in each tier, used while recomputing the loaded chunks
+                std::vector<glm::ivec2> m_loadIntervals;
+                std::vector<glm::ivec2> m_keepIntervals;
+                std::vector<std::pair<int, uint64_t>> m_recentUnloads; // Id of the chunks unloaded recently and tick of their unload (used to detect thrashing)
+                std::vector<std::map<int, Chunk>::node_type> m_freeChunkNodes; // Nodes of the unloaded chunks, reused when other chunks are loaded
+                LightEngine             m_lightEngine;          // Keeps the light levels of the loaded chunks up to date
+                FluidSimulator          m_fluidSimulator;       // Makes water and lava flow
+                TickScheduler           m_tickScheduler;        // Keeps track of the blocks that must be updated in the next ticks
+                RandomTicker            m_randomTicker;         // Updates random blocks in the loaded chunks
+                ExplosionSimulator      m_explosionSimulator;   // Makes TNT blocks explode
+                std::vector<FallingColumn> m_fallingColumns;    // Columns of blocks that are currently falling
+                std::vector<glm::ivec2> m_gravityChecks;        // Positions of the blocks that may have lost their support since the last check
+                std::mt19937            m_rng;                  // Used for the random events of the world (sapling growth, ...)
+                TaskPool                m_taskPool;             // Threads used to update the chunks in parallel
+
+                uint64_t                m_currTick;             // Number of ticks simulated since the world has been created/loaded
+                uint32_t                m_currStep;             // Number of simulation steps executed since the last world tick
         };
 
 }
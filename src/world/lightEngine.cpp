@@ -0,0 +1,308 @@
+
+#include "lightEngine.hpp"
+#include "gameWorld.hpp"
+#include "worldEncyclopedia.hpp"
+
+namespace mc2d {
+
+
+        // Offsets used to visit the 4 neighbors of a block, the last one is the block below
+        static constexpr int NEIGHBORS_NUM = 4;
+        static constexpr int neighborOffsetX[NEIGHBORS_NUM] = { -1, 1, 0,  0 };
+        static constexpr int neighborOffsetY[NEIGHBORS_NUM] = {  0, 0, 1, -1 };
+        static constexpr int DOWN_NEIGHBOR = 3;
+
+
+        LightEngine::LightEngine() : m_cachedChunk(nullptr), m_cachedChunkId(0)
+        {}
+
+
+        // Computes the light levels of all the blocks in the given chunk, light coming from the adjacent chunks
+        // (if loaded) is taken into account and the light of the given chunk is spread into them too
+        // @world: the world that contains the chunk
+        // @chunk: the chunk for which light must be computed (must already be in the loaded chunks of the world)
+        void LightEngine::computeChunkLight(GameWorld& world, Chunk& chunk)
+        {
+                m_cachedChunk = nullptr;
+                chunk.invalidateSnapshot();
+
+                if(chunk.skyLight.capacity() == 0)
+                        chunk.skyLight = ChunkBufferPool::acquireLevels();
+
+                if(chunk.blockLight.capacity() == 0)
+                        chunk.blockLight = ChunkBufferPool::acquireLevels();
+
+                chunk.skyLight.assign(Chunk::width * Chunk::height, 0);
+                chunk.blockLight.assign(Chunk::width * Chunk::height, 0);
+
+                int firstX = chunk.id * Chunk::width;
+                for(int x = firstX; x < firstX + Chunk::width; ++x)
+                {
+                        for(int y = 0; y < Chunk::height; ++y)
+                        {
+                                size_t index = chunk.getBlockIndex(x, y);
+                                for(int channel = 0; channel < LIGHT_CHANNELS_NUM; ++channel)
+                                {
+                                        uint8_t sourceLevel = getSourceLevel((LightChannel) channel, y, chunk.blocks[index]);
+                                        if(sourceLevel == 0)
+                                                continue;
+
+                                        (channel == SKY_LIGHT ? chunk.skyLight : chunk.blockLight)[index] = sourceLevel;
+                                        m_propagationQueue[channel].push_back( { x, y, 0 } );
+                                }
+                        }
+                }
+
+                // Light in the border columns of the adjacent chunks must flow into this chunk too
+                for(int y = 0; y < Chunk::height; ++y)
+                {
+                        for(int channel = 0; channel < LIGHT_CHANNELS_NUM; ++channel)
+                        {
+                                uint8_t* leftLight = getLight(world, (LightChannel) channel, firstX - 1, y);
+                                uint8_t* rightLight = getLight(world, (LightChannel) channel, firstX + Chunk::width, y);
+
+                                if(leftLight != nullptr && *leftLight > 1)
+                                        m_propagationQueue[channel].push_back( { firstX - 1, y, 0 } );
+
+                                if(rightLight != nullptr && *rightLight > 1)
+                                        m_propagationQueue[channel].push_back( { firstX + Chunk::width, y, 0 } );
+                        }
+                }
+
+                propagateLight(world, SKY_LIGHT);
+                propagateLight(world, BLOCK_LIGHT);
+        }
+
+
+        // Notifies the light engine that the block at the given position has changed, the light is not
+        // updated until update() gets called (so that multiple changes can be processed in one single pass)
+        // @world: the world in which the block has changed
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        void LightEngine::onBlockChanged(GameWorld& world, int x, int y)
+        {
+                m_cachedChunk = nullptr;
+
+                for(int channel = 0; channel < LIGHT_CHANNELS_NUM; ++channel)
+                {
+                        uint8_t* light = getLight(world, (LightChannel) channel, x, y);
+                        if(light == nullptr)
+                                return;
+
+                        // Darken the block, all the light that depended on it will be removed during the update
+                        if(*light != 0)
+                        {
+                                m_removalQueue[channel].push_back( { x, y, *light } );
+                                *light = 0;
+                        }
+
+                        // The new block may be a light source
+                        m_reseedQueue[channel].push_back( { x, y, 0 } );
+
+                        // The new block may let the light of its neighbors pass through it
+                        for(int i = 0; i < NEIGHBORS_NUM; ++i)
+                        {
+                                uint8_t* neighborLight = getLight(world, (LightChannel) channel, x + neighborOffsetX[i], y + neighborOffsetY[i]);
+                                if(neighborLight != nullptr && *neighborLight > 1)
+                                        m_propagationQueue[channel].push_back( { x + neighborOffsetX[i], y + neighborOffsetY[i], 0 } );
+                        }
+                }
+        }
+
+
+        // Updates the light in the regions affected by the block changes notified since the last update
+        // @world: the world in which light must be updated
+        void LightEngine::update(GameWorld& world)
+        {
+                m_cachedChunk = nullptr;
+
+                for(int channel = 0; channel < LIGHT_CHANNELS_NUM; ++channel)
+                {
+                        if(m_removalQueue[channel].empty() && m_reseedQueue[channel].empty() && m_propagationQueue[channel].empty())
+                                continue;
+
+                        removeLight(world, (LightChannel) channel);
+                        reseedLight(world, (LightChannel) channel);
+                        propagateLight(world, (LightChannel) channel);
+                }
+        }
+
+
+        // Removes all the light that depends on the blocks in the removal queue, the neighbors that have light
+        // coming from other sources are added to the propagation queue so that the darkened region can be lit again
+        // @world: the world in which light must be removed
+        // @channel: the type of light to be removed
+        void LightEngine::removeLight(GameWorld& world, LightChannel channel)
+        {
+                std::vector<LightNode>& queue = m_removalQueue[channel];
+
+                for(size_t head = 0; head < queue.size(); ++head)
+                {
+                        const LightNode node = queue[head];
+
+                        for(int i = 0; i < NEIGHBORS_NUM; ++i)
+                        {
+                                int neighborX = node.x + neighborOffsetX[i];
+                                int neighborY = node.y + neighborOffsetY[i];
+
+                                BlockType neighborBlock;
+                                uint8_t* neighborLight = getLight(world, channel, neighborX, neighborY, &neighborBlock);
+                                if(neighborLight == nullptr || *neighborLight == 0)
+                                        continue;
+
+                                // Sky light at max level travels down without being attenuated, so a block below
+                                // with the same level may still depend on the removed one
+                                bool isDependent = *neighborLight < node.level ||
+                                        (channel == SKY_LIGHT && i == DOWN_NEIGHBOR && node.level == MAX_LIGHT_LEVEL && *neighborLight == MAX_LIGHT_LEVEL);
+
+                                if(isDependent)
+                                {
+                                        queue.push_back( { neighborX, neighborY, *neighborLight } );
+                                        *neighborLight = 0;
+
+                                        if(getSourceLevel(channel, neighborY, neighborBlock) != 0)
+                                                m_reseedQueue[channel].push_back( { neighborX, neighborY, 0 } );
+                                } else {
+                                        m_propagationQueue[channel].push_back( { neighborX, neighborY, 0 } );
+                                }
+                        }
+                }
+
+                queue.clear();
+        }
+
+
+        // Lights again the light sources that have been darkened during the removal
+        // @world: the world in which light sources must be restored
+        // @channel: the type of light to be restored
+        void LightEngine::reseedLight(GameWorld& world, LightChannel channel)
+        {
+                for(const LightNode& node : m_reseedQueue[channel])
+                {
+                        BlockType block;
+                        uint8_t* light = getLight(world, channel, node.x, node.y, &block);
+                        if(light == nullptr)
+                                continue;
+
+                        uint8_t sourceLevel = getSourceLevel(channel, node.y, block);
+                        if(sourceLevel > *light)
+                        {
+                                *light = sourceLevel;
+                                m_propagationQueue[channel].push_back(node);
+                        }
+                }
+
+                m_reseedQueue[channel].clear();
+        }
+
+
+        // Spreads the light of the blocks in the propagation queue to their neighbors (flood fill)
+        // @world: the world in which light must be spread
+        // @channel: the type of light to be spread
+        void LightEngine::propagateLight(GameWorld& world, LightChannel channel)
+        {
+                std::vector<LightNode>& queue = m_propagationQueue[channel];
+
+                for(size_t head = 0; head < queue.size(); ++head)
+                {
+                        const LightNode node = queue[head];
+
+                        // The level is read again because it may have changed after the node was queued
+                        uint8_t* light = getLight(world, channel, node.x, node.y);
+                        if(light == nullptr || *light <= 1)
+                                continue;
+
+                        const uint8_t level = *light;
+                        for(int i = 0; i < NEIGHBORS_NUM; ++i)
+                        {
+                                int neighborX = node.x + neighborOffsetX[i];
+                                int neighborY = node.y + neighborOffsetY[i];
+
+                                BlockType neighborBlock;
+                                uint8_t* neighborLight = getLight(world, channel, neighborX, neighborY, &neighborBlock);
+                                if(neighborLight == nullptr)
+                                        continue;
+
+                                int opacity = WorldEncyclopedia::getBlockProperties(neighborBlock).lightOpacity;
+                                int newLevel = level - (opacity > 1 ? opacity : 1);
+
+                                if(channel == SKY_LIGHT && i == DOWN_NEIGHBOR && level == MAX_LIGHT_LEVEL && opacity == 0)
+                                        newLevel = MAX_LIGHT_LEVEL;
+
+                                if(newLevel > (int) *neighborLight)
+                                {
+                                        *neighborLight = (uint8_t) newLevel;
+                                        queue.push_back( { neighborX, neighborY, 0 } );
+                                }
+                        }
+                }
+
+                queue.clear();
+        }
+
+
+        // Returns the loaded chunk that contains the block at the given world coordinates
+        // @world: the world in which the chunk will be searched
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: pointer to the chunk if it is loaded and has light data, nullptr otherwise (its snapshot is dropped)
+        Chunk* LightEngine::findChunk(GameWorld& world, int x, int y)
+        {
+                if(y < 0 || y >= (int) Chunk::height)
+                        return nullptr;
+
+                int chunkId = Chunk::getIdFromBlockX(x);
+                if(m_cachedChunk != nullptr && m_cachedChunkId == chunkId)
+                        return m_cachedChunk;
+
+                Chunk* c = world.findChunk(x, y);
+                if(c == nullptr || c->skyLight.empty())
+                        return nullptr;
+
+                // The light levels of the chunk are changed through the pointers returned by getLight()
+                c->invalidateSnapshot();
+                m_cachedChunk = c;
+                m_cachedChunkId = chunkId;
+                return m_cachedChunk;
+        }
+
+
+        // Returns a pointer to the light level of the given type for the block at the given world coordinates
+        // @world: the world that contains the block
+        // @channel: the type of light requested
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: if not null the type of the block will be written in it
+        // @returns: pointer to the light level, nullptr if the block is not in a loaded chunk
+        uint8_t* LightEngine::getLight(GameWorld& world, LightChannel channel, int x, int y, BlockType* block)
+        {
+                Chunk* c = findChunk(world, x, y);
+                if(c == nullptr)
+                        return nullptr;
+
+                size_t index = c->getBlockIndex(x, y);
+                if(block != nullptr)
+                        *block = c->blocks[index];
+
+                return channel == SKY_LIGHT ? &(c->skyLight[index]) : &(c->blockLight[index]);
+        }
+
+
+        // Returns the light level that a block emits by itself
+        // @channel: the type of light requested
+        // @y: y coordinate of the block in world space (blocks in the top row of a chunk are exposed to the sky)
+        // @block: the type of block
+        uint8_t LightEngine::getSourceLevel(LightChannel channel, int y, BlockType block) const
+        {
+                const BlockProperties& props = WorldEncyclopedia::getBlockProperties(block);
+
+                if(channel == BLOCK_LIGHT)
+                        return props.lightEmission;
+
+                if(y != (int) Chunk::height - 1 || props.lightOpacity >= MAX_LIGHT_LEVEL)
+                        return 0;
+
+                return MAX_LIGHT_LEVEL - props.lightOpacity;
+        }
+
+}
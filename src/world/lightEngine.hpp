@@ -0,0 +1,75 @@
+
+// Contains definition of the LightEngine class, this class is responsible for computing the light level of
+// all the blocks contained in the loaded chunks.
+//
+// Two types of light are tracked for each block:
+//      - sky light: enters each chunk from its top row and travels down without losing intensity until it meets
+//        a block that absorbs some of it, the day-night cycle only scales it at render time.
+//      - block light: light emitted by blocks such as lava or active furnaces.
+//
+// Light is spread using a breadth first flood fill, each step towards an adjacent block reduces the light level
+// by the opacity of such block (and at least by one).
+// When a block changes only the region of the world that depends on it gets updated: the light that came from (or passed through)
+// the old block is removed and then the light sources at the border of the removed region are propagated again, the
+// updated region can span multiple chunks. A full computation of the light is done only when a chunk gets loaded.
+//
+
+#ifndef LIGHT_ENGINE_H
+#define LIGHT_ENGINE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+        struct Chunk;
+
+
+        class LightEngine {
+        public:
+                LightEngine();
+                ~LightEngine() = default;
+
+                void                    computeChunkLight(GameWorld& world, Chunk& chunk);
+                void                    onBlockChanged(GameWorld& world, int x, int y);
+                void                    update(GameWorld& world);
+
+        private:
+
+                enum LightChannel {
+                        SKY_LIGHT = 0,
+                        BLOCK_LIGHT,
+
+                        LIGHT_CHANNELS_NUM      // Keep me last!
+                };
+
+                struct LightNode {
+                        int             x;              // X coordinate of the block in world space
+                        int             y;              // Y coordinate of the block in world space
+                        uint8_t         level;          // Light level that the block had before being darkened (used only during removal)
+                };
+
+                void                    removeLight(GameWorld& world, LightChannel channel);
+                void                    reseedLight(GameWorld& world, LightChannel channel);
+                void                    propagateLight(GameWorld& world, LightChannel channel);
+
+                Chunk*                  findChunk(GameWorld& world, int x, int y);
+                uint8_t*                getLight(GameWorld& world, LightChannel channel, int x, int y, BlockType* block = nullptr);
+                uint8_t                 getSourceLevel(LightChannel channel, int y, BlockType block) const;
+
+                Chunk*                  m_cachedChunk;                                  // Last chunk accessed, most lookups hit the same chunk
+                int                     m_cachedChunkId;
+
+                // Work queues are kept between updates so that their memory can be reused
+                std::vector<LightNode>  m_removalQueue[LIGHT_CHANNELS_NUM];             // Blocks that have been darkened and whose neighbors must be checked
+                std::vector<LightNode>  m_propagationQueue[LIGHT_CHANNELS_NUM];         // Blocks whose light must be spread to the neighbors
+                std::vector<LightNode>  m_reseedQueue[LIGHT_CHANNELS_NUM];              // Blocks that may be light sources and must be lit again after the removal
+        };
+
+}
+
+#endif // LIGHT_ENGINE_H
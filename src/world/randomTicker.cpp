@@ -0,0 +1,227 @@
+
+#include "randomTicker.hpp"
+#include "gameWorld.hpp"
+#include "worldEncyclopedia.hpp"
+
+namespace mc2d {
+
+
+        // The checkerboard schedule requires the blocks to never reach further than the chunks next to their own
+        static_assert(LEAF_DECAY_DISTANCE < (int) Chunk::width, "Random ticks must not reach blocks two chunks away");
+
+
+        RandomTicker::RandomTicker() : m_ticksPerChunk(DEFAULT_RANDOM_TICKS_PER_CHUNK), m_ticksBudget(DEFAULT_RANDOM_TICKS_BUDGET), m_nextChunkId(0)
+        {}
+
+
+        // Updates some random blocks in each ticking chunk (up to the ticks budget)
+        // @world: the world in which random ticks must be executed
+        // @currTick: number of the current world tick
+        void RandomTicker::tick(GameWorld& world, uint64_t currTick)
+        {
+                std::map<int, Chunk>& chunks = world.m_loadedChunks;
+                if(chunks.empty() || m_ticksPerChunk == 0)
+                        return;
+
+                // Continue from the chunk that has been skipped in the previous tick (if any)
+                auto c = chunks.lower_bound(m_nextChunkId);
+                if(c == chunks.end())
+                        c = chunks.begin();
+
+                size_t samples = 0;
+                m_phaseChunks[0].clear();
+                m_phaseChunks[1].clear();
+
+                for(size_t i = 0; i < chunks.size(); ++i)
+                {
+                        if(samples + m_ticksPerChunk > m_ticksBudget)
+                        {
+                                m_nextChunkId = c->first;
+                                break;
+                        }
+
+                        if(c->second.tier == ChunkTier::TICKING && c->second.randomTickBlocksNum != 0)
+                        {
+                                m_phaseChunks[c->first & 1].push_back(&(c->second));
+                                samples += m_ticksPerChunk;
+                        }
+
+                        if(++c == chunks.end())
+                                c = chunks.begin();
+                }
+
+                bool blocksChanged = false;
+
+                for(const std::vector<const Chunk*>& phaseChunks : m_phaseChunks)
+                {
+                        if(m_outboxes.size() < phaseChunks.size())
+                                m_outboxes.resize(phaseChunks.size());
+
+                        auto sample = [&](size_t i) {
+                                m_outboxes[i].clear();
+                                sampleChunk(world, *phaseChunks[i], currTick, m_outboxes[i]);
+                        };
+
+                        if(phaseChunks.size() < MIN_PARALLEL_RANDOM_TICK_CHUNKS)
+                        {
+                                for(size_t i = 0; i < phaseChunks.size(); ++i)
+                                        sample(i);
+                        } else {
+                                world.m_taskPool.run(phaseChunks.size(), sample);
+                        }
+
+                        blocksChanged |= applyOutboxes(world, phaseChunks.size());
+                }
+
+                if(blocksChanged)
+                        world.m_lightEngine.update(world);
+        }
+
+
+        // Samples some random blocks of a chunk, it only reads the world (so it can be called concurrently on chunks that are
+        // not adjacent) and writes the changes decided by the blocks in the given outbox
+        // @world: the world that contains the chunk
+        // @chunk: the chunk to sample
+        // @currTick: number of the current world tick
+        // @outbox: vector in which the changes are appended
+        void RandomTicker::sampleChunk(GameWorld& world, const Chunk& chunk, uint64_t currTick, std::vector<BlockChange>& outbox) const
+        {
+                const uint64_t chunkSeed = hash(world.m_worldSeed ^ ((uint64_t) (uint32_t) chunk.id << 32));
+
+                for(uint32_t sample = 0; sample < m_ticksPerChunk; ++sample)
+                {
+                        // The lower bits choose the block, the upper ones are left to the block behaviour
+                        uint64_t random = hash(chunkSeed ^ (currTick * m_ticksPerChunk + sample));
+                        size_t index = (size_t) ((random & 0xFFFFFFFF) % (Chunk::width * Chunk::height));
+
+                        int x = (chunk.id * Chunk::width) + (int) (index % Chunk::width);
+                        int y = Chunk::height - 1 - (int) (index / Chunk::width);
+
+                        BlockType block = chunk.blocks[index];
+                        if(WorldEncyclopedia::getBlockProperties(block).randomTicks)
+                                randomTick(world, x, y, block, random >> 32, outbox);
+                }
+        }
+
+
+        // Applies the changes in the outboxes of the current phase (in the order of the chunks), a change is discarded if the
+        // block that it replaces is not there anymore
+        // @world: the world to modify
+        // @chunksNum: number of chunks in the current phase
+        // @returns: true if some blocks have been changed, false otherwise
+        bool RandomTicker::applyOutboxes(GameWorld& world, size_t chunksNum)
+        {
+                bool blocksChanged = false;
+
+                for(size_t i = 0; i < chunksNum; ++i)
+                {
+                        for(const BlockChange& change : m_outboxes[i])
+                        {
+                                if(getBlock(world, change.x, change.y) == change.expected)
+                                        blocksChanged |= world.placeBlock(change.x, change.y, change.block);
+                        }
+                }
+
+                return blocksChanged;
+        }
+
+
+        // Executes a random tick on the given block
+        // @world: the world that contains the block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: the type of the block
+        // @random: random bits that can be used by the block behaviour
+        // @outbox: vector in which the changes decided by the block are appended
+        void RandomTicker::randomTick(GameWorld& world, int x, int y, BlockType block, uint64_t random, std::vector<BlockChange>& outbox) const
+        {
+                switch(block)
+                {
+                        case BlockType::GRASS:
+                        case BlockType::GRASS_SNOW:
+                        case BlockType::MICELIUM:
+                                spreadGrass(world, x, y, block, random, outbox);
+                                break;
+
+                        case BlockType::OAK_LEAF:
+                        case BlockType::BIRCH_LEAF:
+                        case BlockType::JUNGLE_LEAF:
+                        case BlockType::SPRUCE_LEAF:
+                                decayLeaves(world, x, y, block, outbox);
+                                break;
+
+                        default:
+                                break;
+                }
+        }
+
+
+        // Grass (and the blocks that behave like it) turns into dirt when covered by an opaque block, otherwise it spreads
+        // to one random dirt block around it that is not covered
+        // @world: the world that contains the block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: the type of the block
+        // @random: random bits used to choose the block to spread on
+        // @outbox: vector in which the changes are appended
+        void RandomTicker::spreadGrass(GameWorld& world, int x, int y, BlockType block, uint64_t random, std::vector<BlockChange>& outbox) const
+        {
+                if(WorldEncyclopedia::getBlockProperties(getBlock(world, x, y + 1)).lightOpacity >= MAX_LIGHT_LEVEL)
+                {
+                        outbox.push_back( { x, y, block, BlockType::DIRT } );
+                        return;
+                }
+
+                int targetX = x + (int) (random % 3) - 1;
+                int targetY = y + (int) ((random / 3) % 3) - 1;
+
+                if(getBlock(world, targetX, targetY) != BlockType::DIRT ||
+                        WorldEncyclopedia::getBlockProperties(getBlock(world, targetX, targetY + 1)).lightOpacity >= MAX_LIGHT_LEVEL)
+                        return;
+
+                outbox.push_back( { targetX, targetY, BlockType::DIRT, block } );
+        }
+
+
+        // Leaves decay if there are no logs near them (and all the blocks near them are loaded)
+        // @world: the world that contains the block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: the type of the leaves
+        // @outbox: vector in which the changes are appended
+        void RandomTicker::decayLeaves(GameWorld& world, int x, int y, BlockType block, std::vector<BlockChange>& outbox) const
+        {
+                for(int logY = y - LEAF_DECAY_DISTANCE; logY <= y + LEAF_DECAY_DISTANCE; ++logY)
+                {
+                        if(logY < 0 || logY >= (int) Chunk::height)
+                                continue;
+
+                        for(int logX = x - LEAF_DECAY_DISTANCE; logX <= x + LEAF_DECAY_DISTANCE; ++logX)
+                        {
+                                // The log may be in a chunk that is not loaded
+                                if(world.findChunk(logX, logY) == nullptr)
+                                        return;
+
+                                BlockType neighbor = getBlock(world, logX, logY);
+                                if(neighbor == BlockType::OAK_WOOD || neighbor == BlockType::BIRCH_WOOD ||
+                                        neighbor == BlockType::JUNGLE_WOOD || neighbor == BlockType::SPRUCE_WOOD)
+                                        return;
+                        }
+                }
+
+                outbox.push_back( { x, y, block, BlockType::AIR } );
+        }
+
+
+        // Returns the block at the given position
+        // @world: the world that contains the block
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: the block type, if the block is not in a loaded chunk then air is returned
+        BlockType RandomTicker::getBlock(GameWorld& world, int x, int y)
+        {
+                Chunk* c = world.findChunk(x, y);
+                return c == nullptr ? BlockType::AIR : c->blocks[c->getBlockIndex(x, y)];
+        }
+
+}
@@ -0,0 +1,91 @@
+
+// Contains definition of the RandomTicker class, this class implements the random ticks: each world tick a few random
+// blocks of every ticking chunk are updated, this drives all the slow and unpredictable changes of the world (grass that
+// spreads on dirt, leaves that decay when their tree has been cut, ...).
+//
+// Random positions are generated with a stateless hash of the world seed, the chunk id, the current tick and the sample
+// number, so no random generator state needs to be stored or copied. Each chunk keeps the number of its blocks that react
+// to random ticks, chunks that do not contain such blocks are skipped without sampling them.
+// The total number of samples taken in one tick is limited by a budget, when the budget is not enough to sample all the
+// ticking chunks the next tick continues from the first chunk that has been skipped.
+//
+// Chunks are sampled in parallel with a checkerboard schedule: chunks with an even id in a first phase and chunks with an
+// odd id in a second one. Blocks react only to blocks closer than one chunk width, so while a chunk is sampled its
+// neighbors are never sampled at the same time. Sampling a chunk does not modify the world, the changes decided by the
+// blocks are written in the outbox of the chunk (they may target a neighbor chunk) and the outboxes of a phase are
+// applied at its end, one chunk after the other in the order in which chunks have been selected. Each change keeps the
+// block that it expects to replace and it is discarded if that block has been changed in the meantime. In this way the
+// result never depends on the number of threads nor on the order in which the chunks of a phase are sampled.
+//
+
+#ifndef RANDOM_TICKER_H
+#define RANDOM_TICKER_H
+
+#include <vector>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+        class GameWorld;
+        struct Chunk;
+
+
+        constexpr uint32_t DEFAULT_RANDOM_TICKS_PER_CHUNK = 3;         // Default number of blocks sampled in each chunk per tick
+        constexpr size_t DEFAULT_RANDOM_TICKS_BUDGET = 1024;            // Default maximum number of blocks sampled in one tick
+        constexpr int LEAF_DECAY_DISTANCE = 4;                          // Leaves that have no log closer than this (on both axes) decay
+        constexpr size_t MIN_PARALLEL_RANDOM_TICK_CHUNKS = 32;          // Phases with fewer chunks than this are sampled on the calling thread
+
+
+        class RandomTicker {
+        public:
+                RandomTicker();
+                ~RandomTicker() = default;
+
+                void                    tick(GameWorld& world, uint64_t currTick);
+
+                inline void             setTicksPerChunk(uint32_t ticks)        { m_ticksPerChunk = ticks; }
+                inline void             setTicksBudget(size_t budget)           { m_ticksBudget = budget; }
+                inline uint32_t         getTicksPerChunk() const                { return m_ticksPerChunk; }
+                inline size_t           getTicksBudget() const                  { return m_ticksBudget; }
+
+                // Mixes the bits of the given value (splitmix64 finalizer), used as a stateless random number generator
+                static inline uint64_t  hash(uint64_t value)
+                {
+                        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+                        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+                        return value ^ (value >> 31);
+                }
+
+        private:
+
+                // Change of a block decided during a random tick (applied at the end of the phase)
+                struct BlockChange {
+                        int             x;
+                        int             y;
+                        BlockType       expected;               // Block that must still be at the position for the change to be applied
+                        BlockType       block;                  // The new block
+                };
+
+                void                    sampleChunk(GameWorld& world, const Chunk& chunk, uint64_t currTick, std::vector<BlockChange>& outbox) const;
+                bool                    applyOutboxes(GameWorld& world, size_t chunksNum);
+
+                void                    randomTick(GameWorld& world, int x, int y, BlockType block, uint64_t random, std::vector<BlockChange>& outbox) const;
+                void                    spreadGrass(GameWorld& world, int x, int y, BlockType block, uint64_t random, std::vector<BlockChange>& outbox) const;
+                void                    decayLeaves(GameWorld& world, int x, int y, BlockType block, std::vector<BlockChange>& outbox) const;
+
+                static BlockType        getBlock(GameWorld& world, int x, int y);
+
+                uint32_t                m_ticksPerChunk;        // Number of blocks sampled in each chunk per tick
+                size_t                  m_ticksBudget;          // Maximum number of blocks sampled in one tick
+                int                     m_nextChunkId;          // Chunk from which the next tick will start sampling
+
+                std::vector<const Chunk*> m_phaseChunks[2];     // Chunks selected in the current tick (one vector for the even and one for the odd chunks)
+                std::vector<std::vector<BlockChange>> m_outboxes; // Changes decided by each chunk of the current phase
+        };
+
+}
+
+#endif // RANDOM_TICKER_H
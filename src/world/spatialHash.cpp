@@ -0,0 +1,197 @@
+
+#include "spatialHash.hpp"
+#include "worldEncyclopedia.hpp"
+
+#if defined(__SSE2__)
+        #include <emmintrin.h>
+#endif
+
+namespace mc2d {
+
+
+        SpatialHash::SpatialHash() : m_bucketsNum(1), m_maxEntitySize(0.0f), m_bucketStarts( { 0, 0 } )
+        {}
+
+
+        // Rebuilds the hash table with the current positions of the entities
+        // @entities: the entities to insert in the table
+        void SpatialHash::rebuild(const EntityStore& entities)
+        {
+                const size_t entitiesNum = entities.getEntitiesNum();
+
+                // Use about two buckets for each entity so that few cells share the same bucket
+                m_bucketsNum = 16;
+                while(m_bucketsNum < 2 * entitiesNum)
+                        m_bucketsNum *= 2;
+
+                m_bucketStarts.assign(m_bucketsNum + 1, 0);
+                m_entityBuckets.clear();
+                m_maxEntitySize = 0.0f;
+
+                // Count the entities that fall in each bucket
+                for(size_t type = 0; type < ENTITY_TYPES_NUM; ++type)
+                {
+                        const EntityArchetype& a = entities.getArchetype(static_cast<EntityType>(type));
+                        const EntityProperties& props = WorldEncyclopedia::getEntityProperties(static_cast<EntityType>(type));
+
+                        if(a.size() != 0)
+                                m_maxEntitySize = std::max(m_maxEntitySize, std::max(props.width, props.height));
+
+                        for(size_t i = 0; i < a.size(); ++i)
+                        {
+                                uint32_t bucket = getBucket(getCell(a.posX[i]), getCell(a.posY[i]));
+                                m_entityBuckets.push_back(bucket);
+                                ++m_bucketStarts[bucket + 1];
+                        }
+                }
+
+                for(uint32_t i = 0; i < m_bucketsNum; ++i)
+                        m_bucketStarts[i + 1] += m_bucketStarts[i];
+
+                // Then place each entity after the ones that precede it in its bucket
+                m_handles.resize(entitiesNum);
+                m_minX.assign(entitiesNum + 3, 0.0f);
+                m_minY.assign(entitiesNum + 3, 0.0f);
+                m_maxX.assign(entitiesNum + 3, 0.0f);
+                m_maxY.assign(entitiesNum + 3, 0.0f);
+
+                std::vector<uint32_t>& nextIndex = m_bucketStarts;      // The starts are shifted by one bucket while filling
+                size_t e = 0;
+
+                for(size_t type = 0; type < ENTITY_TYPES_NUM; ++type)
+                {
+                        const EntityArchetype& a = entities.getArchetype(static_cast<EntityType>(type));
+                        const EntityProperties& props = WorldEncyclopedia::getEntityProperties(static_cast<EntityType>(type));
+
+                        for(size_t i = 0; i < a.size(); ++i, ++e)
+                        {
+                                uint32_t index = nextIndex[m_entityBuckets[e]]++;
+
+                                m_handles[index] = entities.getHandle(static_cast<EntityType>(type), i);
+                                m_minX[index] = a.posX[i];
+                                m_minY[index] = a.posY[i];
+                                m_maxX[index] = a.posX[i] + props.width;
+                                m_maxY[index] = a.posY[i] + props.height;
+                        }
+                }
+
+                // Each start has been moved to the start of the next bucket, move them back
+                for(uint32_t i = m_bucketsNum; i > 0; --i)
+                        m_bucketStarts[i] = m_bucketStarts[i - 1];
+
+                m_bucketStarts[0] = 0;
+        }
+
+
+        // Finds the entities whose collision box intersects the given rectangle
+        // @x, @y: coordinates of the bottom left corner of the rectangle
+        // @width, @height: size of the rectangle
+        // @result: the handles of the entities found are appended to it
+        void SpatialHash::queryRect(float x, float y, float width, float height, std::vector<EntityHandle>& result) const
+        {
+                forEachIntersection(x, y, x + width, y + height, [&](size_t i) {
+                        result.push_back(m_handles[i]);
+                });
+        }
+
+
+        // Finds the entities whose collision box intersects the given circle
+        // @x, @y: coordinates of the center of the circle
+        // @radius: radius of the circle
+        // @result: the handles of the entities found are appended to it
+        void SpatialHash::queryRadius(float x, float y, float radius, std::vector<EntityHandle>& result) const
+        {
+                const float radiusSquared = radius * radius;
+
+                // Test the boxes against the square around the circle, then measure the distance between the center and the box
+                forEachIntersection(x - radius, y - radius, x + radius, y + radius, [&](size_t i) {
+                        float distanceX = x - std::clamp(x, m_minX[i], m_maxX[i]);
+                        float distanceY = y - std::clamp(y, m_minY[i], m_maxY[i]);
+
+                        if(distanceX * distanceX + distanceY * distanceY <= radiusSquared)
+                                result.push_back(m_handles[i]);
+                });
+        }
+
+
+        // Finds all the pairs of entities whose collision boxes intersect each other, each pair is reported only once
+        // @pairs: the pairs found are appended to it
+        void SpatialHash::findPairs(std::vector<std::pair<EntityHandle, EntityHandle>>& pairs) const
+        {
+                for(size_t i = 0; i < m_handles.size(); ++i)
+                {
+                        forEachIntersection(m_minX[i], m_minY[i], m_maxX[i], m_maxY[i], [&](size_t j) {
+                                if(j > i)
+                                        pairs.push_back( { m_handles[i], m_handles[j] } );
+                        });
+                }
+        }
+
+
+        // Finds the ranges of entities that must be tested by a query, a range is returned for each bucket that contains a
+        // cell that may have entities intersecting the query rectangle (buckets are never repeated)
+        // @minX, @minY, @maxX, @maxY: the query rectangle
+        // @ranges: array of MAX_QUERY_CELLS elements in which the ranges are written
+        // @returns: the number of ranges, if the rectangle covers too many cells a single range with all the entities is returned
+        int SpatialHash::getRanges(float minX, float minY, float maxX, float maxY, Range* ranges) const
+        {
+                // Entities are assigned to the cell of their bottom left corner so the cells to the left and below of the
+                // rectangle may contain entities that intersect it
+                const int firstCellX = getCell(minX - m_maxEntitySize);
+                const int firstCellY = getCell(minY - m_maxEntitySize);
+                const int lastCellX = getCell(maxX);
+                const int lastCellY = getCell(maxY);
+
+                if((int64_t) (lastCellX - firstCellX + 1) * (lastCellY - firstCellY + 1) > MAX_QUERY_CELLS)
+                {
+                        ranges[0] = { 0, m_handles.size() };
+                        return 1;
+                }
+
+                uint32_t buckets[MAX_QUERY_CELLS];
+                int bucketsNum = 0;
+
+                for(int cellY = firstCellY; cellY <= lastCellY; ++cellY)
+                {
+                        for(int cellX = firstCellX; cellX <= lastCellX; ++cellX)
+                        {
+                                uint32_t bucket = getBucket(cellX, cellY);
+                                if(m_bucketStarts[bucket] == m_bucketStarts[bucket + 1] || std::find(buckets, buckets + bucketsNum, bucket) != buckets + bucketsNum)
+                                        continue;
+
+                                ranges[bucketsNum] = { m_bucketStarts[bucket], m_bucketStarts[bucket + 1] };
+                                buckets[bucketsNum++] = bucket;
+                        }
+                }
+
+                return bucketsNum;
+        }
+
+
+        // Tests 4 consecutive collision boxes (in the sorted arrays) against a rectangle
+        // @first: index of the first box to test
+        // @minX, @minY, @maxX, @maxY: the rectangle
+        // @returns: a mask in which bit i is set if the box first + i intersects the rectangle
+        uint32_t SpatialHash::testRects(size_t first, float minX, float minY, float maxX, float maxY) const
+        {
+#if defined(__SSE2__)
+                __m128 hitX = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&m_minX[first]), _mm_set1_ps(maxX)),
+                        _mm_cmplt_ps(_mm_set1_ps(minX), _mm_loadu_ps(&m_maxX[first])));
+                __m128 hitY = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(&m_minY[first]), _mm_set1_ps(maxY)),
+                        _mm_cmplt_ps(_mm_set1_ps(minY), _mm_loadu_ps(&m_maxY[first])));
+
+                return (uint32_t) _mm_movemask_ps(_mm_and_ps(hitX, hitY));
+#else
+                uint32_t hits = 0;
+                for(size_t i = 0; i < 4; ++i)
+                {
+                        size_t e = first + i;
+                        if(m_minX[e] < maxX && minX < m_maxX[e] && m_minY[e] < maxY && minY < m_maxY[e])
+                                hits |= 1u << i;
+                }
+
+                return hits;
+#endif
+        }
+
+}
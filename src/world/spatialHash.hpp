@@ -0,0 +1,97 @@
+
+// Contains definition of the SpatialHash class, this class is used to find quickly the entities that are in a certain
+// region of the world (the entities near a point, the entities that touch each other, ...).
+//
+// The world is divided in a uniform grid of square cells, each entity is assigned to the cell that contains the bottom left
+// corner of its collision box and the cells are mapped to the buckets of a hash table. The table is rebuilt from scratch
+// after each update of the entities with a counting sort: the collision boxes of all the entities are stored sorted by bucket
+// in contiguous arrays (one for each coordinate), so a query only needs to read a few short ranges of such arrays.
+// The boxes of one bucket are tested against the query 4 at a time (with SSE2 when available).
+//
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+#include "log.hpp"
+#include "entityStore.hpp"
+
+namespace mc2d {
+
+
+        constexpr float SPATIAL_HASH_CELL_SIZE = 2.0f;          // Size of the cells of the grid (measured in blocks)
+
+
+        class SpatialHash {
+        public:
+                SpatialHash();
+                ~SpatialHash() = default;
+
+                void                    rebuild(const EntityStore& entities);
+
+                void                    queryRect(float x, float y, float width, float height, std::vector<EntityHandle>& result) const;
+                void                    queryRadius(float x, float y, float radius, std::vector<EntityHandle>& result) const;
+                void                    findPairs(std::vector<std::pair<EntityHandle, EntityHandle>>& pairs) const;
+
+                inline size_t           getEntitiesNum() const                  { return m_handles.size(); }
+
+        private:
+
+                // Number of cells covered by a query above which all the entities are tested (it is faster than visiting so many cells)
+                static constexpr int    MAX_QUERY_CELLS = 64;
+
+                inline int              getCell(float coord) const              { return (int) std::floor(coord / SPATIAL_HASH_CELL_SIZE); }
+                inline uint32_t         getBucket(int cellX, int cellY) const   { return (((uint32_t) cellX * 73856093u) ^ ((uint32_t) cellY * 19349663u)) & (m_bucketsNum - 1); }
+
+                // Range of entities (sorted by bucket) that must be tested by a query
+                struct Range {
+                        size_t          first;
+                        size_t          last;                   // One past the last entity of the range
+                };
+
+                int                     getRanges(float minX, float minY, float maxX, float maxY, Range* ranges) const;
+                uint32_t                testRects(size_t first, float minX, float minY, float maxX, float maxY) const;
+
+                // Calls onHit with the index (in the sorted arrays) of each entity whose collision box intersects the given rectangle
+                template <typename F>
+                void                    forEachIntersection(float minX, float minY, float maxX, float maxY, F onHit) const
+                {
+                        Range ranges[MAX_QUERY_CELLS];
+                        int rangesNum = getRanges(minX, minY, maxX, maxY, ranges);
+
+                        for(int r = 0; r < rangesNum; ++r)
+                        {
+                                for(size_t i = ranges[r].first; i < ranges[r].last; i += 4)
+                                {
+                                        // Lanes after the end of the range are discarded
+                                        uint32_t hits = testRects(i, minX, minY, maxX, maxY);
+                                        if(ranges[r].last - i < 4)
+                                                hits &= (1u << (ranges[r].last - i)) - 1;
+
+                                        for(; hits != 0; hits &= hits - 1)
+                                                onHit(i + __builtin_ctz(hits));
+                                }
+                        }
+                }
+
+                uint32_t                m_bucketsNum;           // Number of buckets of the hash table (always a power of two)
+                float                   m_maxEntitySize;        // Size of the biggest collision box in the table (the queries are extended by it)
+                std::vector<uint32_t>   m_bucketStarts;         // Index of the first entity of each bucket (the last element is the number of entities)
+                std::vector<uint32_t>   m_entityBuckets;        // Bucket of each entity (in the order of the entity store), used while rebuilding
+                std::vector<EntityHandle> m_handles;            // Handles of the entities sorted by bucket
+
+                // Collision boxes of the entities sorted by bucket, each vector has 3 more elements than the number of entities so that
+                // the boxes can always be loaded 4 at a time
+                std::vector<float>      m_minX;
+                std::vector<float>      m_minY;
+                std::vector<float>      m_maxX;
+                std::vector<float>      m_maxY;
+        };
+
+}
+
+#endif // SPATIAL_HASH_H
@@ -0,0 +1,138 @@
+
+#include "taskPool.hpp"
+
+namespace mc2d {
+
+
+        TaskPool::TaskPool() : m_threadsNum(getDefaultThreadsNum()), m_task(nullptr), m_tasksNum(0), m_nextTask(0),
+                m_busyWorkers(0), m_groupId(0), m_stopWorkers(false)
+        {}
+
+
+        TaskPool::TaskPool(const TaskPool& other) : m_threadsNum(other.m_threadsNum), m_task(nullptr), m_tasksNum(0), m_nextTask(0),
+                m_busyWorkers(0), m_groupId(0), m_stopWorkers(false)
+        {}
+
+
+        // Stops the worker threads (if any)
+        TaskPool::~TaskPool()
+        {
+                stopWorkers();
+        }
+
+
+        TaskPool& TaskPool::operator = (const TaskPool& other)
+        {
+                setThreadsNum(other.m_threadsNum);
+                return *this;
+        }
+
+
+        // Executes a group of tasks and waits until all of them have been completed
+        // @tasksNum: number of tasks in the group
+        // @task: function that executes one task, it receives the index of the task (it may be called concurrently)
+        void TaskPool::run(size_t tasksNum, const std::function<void(size_t)>& task)
+        {
+                if(m_threadsNum == 0 || tasksNum <= 1)
+                {
+                        for(size_t i = 0; i < tasksNum; ++i)
+                                task(i);
+
+                        return;
+                }
+
+                if(m_workers.empty())
+                        startWorkers();
+
+                {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_task = &task;
+                        m_tasksNum = tasksNum;
+                        m_nextTask = 0;
+                        m_busyWorkers = m_workers.size();
+                        ++m_groupId;
+                }
+
+                m_wakeWorkers.notify_all();
+                executeTasks();
+
+                // The group is done only when all the workers have left it (they use the task function until then)
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_groupDone.wait(lock, [this] { return m_busyWorkers == 0; });
+                m_task = nullptr;
+        }
+
+
+        // Changes the number of worker threads used by the pool
+        // @threadsNum: the new number of worker threads (zero executes all the tasks on the thread that calls run())
+        void TaskPool::setThreadsNum(size_t threadsNum)
+        {
+                if(threadsNum == m_threadsNum)
+                        return;
+
+                stopWorkers();                                  // Workers will be started again by the next run()
+                m_threadsNum = threadsNum;
+        }
+
+
+        // Starts the worker threads
+        void TaskPool::startWorkers()
+        {
+                m_stopWorkers = false;
+                for(size_t i = 0; i < m_threadsNum; ++i)
+                        m_workers.emplace_back(&TaskPool::workerLoop, this, m_groupId);
+        }
+
+
+        // Stops the worker threads and waits for their termination
+        void TaskPool::stopWorkers()
+        {
+                if(m_workers.empty())
+                        return;
+
+                {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stopWorkers = true;
+                }
+
+                m_wakeWorkers.notify_all();
+                for(std::thread& w : m_workers)
+                        w.join();
+
+                m_workers.clear();
+        }
+
+
+        // Main loop of the worker threads, waits for a group of tasks and helps to execute it
+        // @lastGroupId: id of the last group started before the creation of the worker
+        void TaskPool::workerLoop(uint64_t lastGroupId)
+        {
+                while(true)
+                {
+                        {
+                                std::unique_lock<std::mutex> lock(m_mutex);
+                                m_wakeWorkers.wait(lock, [&] { return m_stopWorkers || m_groupId != lastGroupId; });
+
+                                if(m_stopWorkers)
+                                        return;
+
+                                lastGroupId = m_groupId;
+                        }
+
+                        executeTasks();
+
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if(--m_busyWorkers == 0)
+                                m_groupDone.notify_one();
+                }
+        }
+
+
+        // Executes the tasks of the current group until there are no more tasks left
+        void TaskPool::executeTasks()
+        {
+                for(size_t i = m_nextTask.fetch_add(1); i < m_tasksNum; i = m_nextTask.fetch_add(1))
+                        (*m_task)(i);
+        }
+
+}
@@ -0,0 +1,66 @@
+
+// Contains definition of the TaskPool class, this class runs groups of independent tasks on a set of worker threads.
+//
+// The tasks of a group are identified by their index, the workers (and the thread that runs the group, which works too)
+// take the next index from a shared atomic counter until all the tasks have been executed, run() returns only when the
+// whole group is done. Worker threads are started the first time they are needed and then sleep between the groups.
+// Copying a pool copies only its configuration (each copy starts its own threads).
+//
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include "log.hpp"
+
+namespace mc2d {
+
+
+        class TaskPool {
+        public:
+                TaskPool();
+                TaskPool(const TaskPool& other);
+                ~TaskPool();
+
+                TaskPool&               operator = (const TaskPool& other);
+
+                void                    run(size_t tasksNum, const std::function<void(size_t)>& task);
+
+                void                    setThreadsNum(size_t threadsNum);
+                inline size_t           getThreadsNum() const                   { return m_threadsNum; }
+
+                // Returns the default number of worker threads (one less than the cores, the thread that runs the tasks works too)
+                static inline size_t    getDefaultThreadsNum()                  { unsigned cores = std::thread::hardware_concurrency(); return cores > 1 ? cores - 1 : 0; }
+
+        private:
+
+                void                    startWorkers();
+                void                    stopWorkers();
+                void                    workerLoop(uint64_t lastGroupId);
+                void                    executeTasks();
+
+                size_t                  m_threadsNum;           // Number of worker threads to use (zero runs all the tasks on the calling thread)
+                std::vector<std::thread> m_workers;
+
+                std::mutex              m_mutex;
+                std::condition_variable m_wakeWorkers;          // Signaled when a new group of tasks is available (or the workers must stop)
+                std::condition_variable m_groupDone;            // Signaled when the last busy worker has finished a group
+
+                const std::function<void(size_t)>* m_task;      // Task of the group that is running
+                size_t                  m_tasksNum;             // Number of tasks in the group that is running
+                std::atomic<size_t>     m_nextTask;             // Index of the next task that must be executed
+                size_t                  m_busyWorkers;          // Number of workers that have not finished the current group yet
+                uint64_t                m_groupId;              // Incremented for each group, used by the workers to detect new groups
+                bool                    m_stopWorkers;
+        };
+
+}
+
+#endif // TASK_POOL_H
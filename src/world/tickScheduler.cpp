@@ -0,0 +1,238 @@
+
+#include "tickScheduler.hpp"
+#include "gameWorld.hpp"
+
+namespace mc2d {
+
+
+        TickScheduler::TickScheduler() : m_currTick(0)
+        {
+                for(uint32_t level = 0; level < LEVELS_NUM; ++level)
+                {
+                        for(uint32_t slot = 0; slot < SLOTS_NUM; ++slot)
+                                m_slots[level][slot] = NULL_NODE;
+                }
+        }
+
+
+        // Schedules a tick for the block at the given position, if a tick is already pending for such block it gets replaced
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @block: type of the block, if the block changes before the tick is due then the tick will not be executed
+        // @delay: number of ticks after which the block will be updated (a delay of 1 means the next tick)
+        void TickScheduler::schedule(int x, int y, BlockType block, uint64_t delay)
+        {
+                cancel(x, y);
+
+                uint32_t nodeId;
+                if(!m_freeNodes.empty())
+                {
+                        nodeId = m_freeNodes.back();
+                        m_freeNodes.pop_back();
+                } else {
+                        nodeId = (uint32_t) m_nodes.size();
+                        m_nodes.emplace_back();
+                }
+
+                TimerNode& node = m_nodes[nodeId];
+                node.x = x;
+                node.y = y;
+                node.targetTick = m_currTick + (delay > 0 ? delay - 1 : 0);
+                node.block = block;
+
+                // Link the node at the head of the list of its chunk
+                int chunkId = Chunk::getIdFromBlockX(x);
+                auto head = m_chunkHeads.find(chunkId);
+
+                node.chunkPrev = NULL_NODE;
+                node.chunkNext = head != m_chunkHeads.end() ? head->second : NULL_NODE;
+                if(node.chunkNext != NULL_NODE)
+                        m_nodes[node.chunkNext].chunkPrev = nodeId;
+
+                m_chunkHeads[chunkId] = nodeId;
+                m_nodesByPos[packPos(x, y)] = nodeId;
+
+                insertNode(nodeId);
+        }
+
+
+        // Cancels the tick pending for the block at the given position
+        // @x: x coordinate of the block in world space
+        // @y: y coordinate of the block in world space
+        // @returns: true if a tick was pending for the block, false otherwise
+        bool TickScheduler::cancel(int x, int y)
+        {
+                auto node = m_nodesByPos.find(packPos(x, y));
+                if(node == m_nodesByPos.end())
+                        return false;
+
+                uint32_t nodeId = node->second;
+                unlinkNode(nodeId);
+                freeNode(nodeId);
+                return true;
+        }
+
+
+        // Advances the wheel by one tick
+        // @dueTicks: the ticks that are due in the processed tick will be appended to this vector (with a delay of zero)
+        void TickScheduler::advance(std::vector<ScheduledTick>& dueTicks)
+        {
+                // When the wheel reaches the beginning of a slot of the upper levels its ticks are moved closer (starting from the highest level)
+                if((m_currTick & SLOT_MASK) == 0)
+                {
+                        uint32_t lastLevel = 1;
+                        while(lastLevel + 1 < LEVELS_NUM && ((m_currTick >> (lastLevel * SLOT_BITS)) & SLOT_MASK) == 0)
+                                ++lastLevel;
+
+                        for(uint32_t level = lastLevel; level > 0; --level)
+                                cascade(level);
+                }
+
+                // Detach the list of the current slot, ticks scheduled while the due ticks are processed never end up in it
+                uint32_t slot = (uint32_t) (m_currTick & SLOT_MASK);
+                uint32_t nodeId = m_slots[0][slot];
+                m_slots[0][slot] = NULL_NODE;
+
+                while(nodeId != NULL_NODE)
+                {
+                        TimerNode& node = m_nodes[nodeId];
+                        uint32_t nextId = node.next;
+
+                        if(node.targetTick <= m_currTick)
+                        {
+                                dueTicks.push_back( { node.x, node.y, 0, node.block } );
+                                freeNode(nodeId);
+                        } else {
+                                insertNode(nodeId);
+                        }
+
+                        nodeId = nextId;
+                }
+
+                ++m_currTick;
+        }
+
+
+        // Copies the ticks pending in the given chunk
+        // @chunkId: id of the chunk
+        // @ticks: the pending ticks will be appended to this vector (their delays are relative to the next tick)
+        void TickScheduler::getChunkTicks(int chunkId, std::vector<ScheduledTick>& ticks) const
+        {
+                auto head = m_chunkHeads.find(chunkId);
+                if(head == m_chunkHeads.end())
+                        return;
+
+                for(uint32_t nodeId = head->second; nodeId != NULL_NODE; nodeId = m_nodes[nodeId].chunkNext)
+                {
+                        const TimerNode& node = m_nodes[nodeId];
+                        uint64_t delay = node.targetTick >= m_currTick ? node.targetTick - m_currTick + 1 : 1;
+
+                        ticks.push_back( { node.x, node.y, delay, node.block } );
+                }
+        }
+
+
+        // Cancels all the ticks pending in the given chunk
+        // @chunkId: id of the chunk
+        void TickScheduler::removeChunkTicks(int chunkId)
+        {
+                auto head = m_chunkHeads.find(chunkId);
+                if(head == m_chunkHeads.end())
+                        return;
+
+                uint32_t nodeId = head->second;
+                while(nodeId != NULL_NODE)
+                {
+                        uint32_t nextId = m_nodes[nodeId].chunkNext;
+                        unlinkNode(nodeId);
+                        freeNode(nodeId);
+                        nodeId = nextId;
+                }
+        }
+
+
+        // Inserts the given node in the slot of the wheel that corresponds to its target tick
+        // @nodeId: index of the node in the pool
+        void TickScheduler::insertNode(uint32_t nodeId)
+        {
+                TimerNode& node = m_nodes[nodeId];
+                uint64_t delta = node.targetTick > m_currTick ? node.targetTick - m_currTick : 0;
+                uint64_t target = node.targetTick > m_currTick ? node.targetTick : m_currTick;
+
+                // Ticks that are too far in the future are placed in the last level, they will be inserted again when their slot is reached
+                uint32_t level = 0;
+                while(level + 1 < LEVELS_NUM && delta >= ((uint64_t) 1 << ((level + 1) * SLOT_BITS)))
+                        ++level;
+
+                uint32_t slot = (uint32_t) ((target >> (level * SLOT_BITS)) & SLOT_MASK);
+
+                node.level = (uint8_t) level;
+                node.slot = (uint8_t) slot;
+                node.prev = NULL_NODE;
+                node.next = m_slots[level][slot];
+
+                if(node.next != NULL_NODE)
+                        m_nodes[node.next].prev = nodeId;
+
+                m_slots[level][slot] = nodeId;
+        }
+
+
+        // Removes the given node from the slot that contains it
+        // @nodeId: index of the node in the pool
+        void TickScheduler::unlinkNode(uint32_t nodeId)
+        {
+                TimerNode& node = m_nodes[nodeId];
+
+                if(node.prev != NULL_NODE)
+                        m_nodes[node.prev].next = node.next;
+                else
+                        m_slots[node.level][node.slot] = node.next;
+
+                if(node.next != NULL_NODE)
+                        m_nodes[node.next].prev = node.prev;
+        }
+
+
+        // Removes the given node from the list of its chunk and gives it back to the pool, the node must not be linked in any slot
+        // @nodeId: index of the node in the pool
+        void TickScheduler::freeNode(uint32_t nodeId)
+        {
+                TimerNode& node = m_nodes[nodeId];
+
+                if(node.chunkPrev != NULL_NODE)
+                {
+                        m_nodes[node.chunkPrev].chunkNext = node.chunkNext;
+                } else {
+                        int chunkId = Chunk::getIdFromBlockX(node.x);
+                        if(node.chunkNext != NULL_NODE)
+                                m_chunkHeads[chunkId] = node.chunkNext;
+                        else
+                                m_chunkHeads.erase(chunkId);
+                }
+
+                if(node.chunkNext != NULL_NODE)
+                        m_nodes[node.chunkNext].chunkPrev = node.chunkPrev;
+
+                m_nodesByPos.erase(packPos(node.x, node.y));
+                m_freeNodes.push_back(nodeId);
+        }
+
+
+        // Moves the nodes in the current slot of the given level to the lower levels
+        // @level: level of the wheel (must be greater than zero)
+        void TickScheduler::cascade(uint32_t level)
+        {
+                uint32_t slot = (uint32_t) ((m_currTick >> (level * SLOT_BITS)) & SLOT_MASK);
+                uint32_t nodeId = m_slots[level][slot];
+                m_slots[level][slot] = NULL_NODE;
+
+                while(nodeId != NULL_NODE)
+                {
+                        uint32_t nextId = m_nodes[nodeId].next;
+                        insertNode(nodeId);
+                        nodeId = nextId;
+                }
+        }
+
+}
@@ -0,0 +1,90 @@
+
+// Contains definition of the TickScheduler class, this class keeps track of the blocks that must be updated at a certain
+// world tick in the future (saplings that grow, furnaces that cool down, TNT fuses, ...).
+//
+// Pending ticks are stored in a hierarchical timer wheel: the first level has one slot for each of the next 64 ticks, each
+// slot of the second level covers 64 ticks, each slot of the third one 64 * 64 ticks and so on. When the wheel reaches the
+// beginning of a slot of an upper level the ticks contained in it are moved to the lower levels, in this way scheduling
+// and cancelling a tick are O(1) operations and the ticks that are far in the future cost nothing until they are due.
+//
+// Only one tick can be pending for each block, scheduling a new tick for a block replaces the previous one.
+// Pending ticks are also linked per chunk so that they can be saved with their chunk and restored when it gets loaded again.
+//
+
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "log.hpp"
+#include "blockTypes.hpp"
+
+namespace mc2d {
+
+
+        // Defines a tick that has been scheduled for a block
+        struct ScheduledTick {
+                int             x;              // X coordinate of the block in world space
+                int             y;              // Y coordinate of the block in world space
+                uint64_t        delay;          // Number of ticks after which the block will be updated
+                BlockType       block;          // Type of the block when the tick was scheduled (if it changes the tick is not executed)
+        };
+
+
+        class TickScheduler {
+        public:
+                TickScheduler();
+                ~TickScheduler() = default;
+
+                void                    schedule(int x, int y, BlockType block, uint64_t delay);
+                bool                    cancel(int x, int y);
+                void                    advance(std::vector<ScheduledTick>& dueTicks);
+
+                void                    getChunkTicks(int chunkId, std::vector<ScheduledTick>& ticks) const;
+                void                    removeChunkTicks(int chunkId);
+
+                inline bool             isScheduled(int x, int y) const         { return m_nodesByPos.find(packPos(x, y)) != m_nodesByPos.end(); }
+                inline size_t           getPendingTicksNum() const              { return m_nodesByPos.size(); }
+                inline uint64_t         getCurrentTick() const                  { return m_currTick; }
+
+        private:
+
+                static constexpr uint32_t       SLOT_BITS = 6;
+                static constexpr uint32_t       SLOTS_NUM = 1 << SLOT_BITS;     // Number of slots in each level of the wheel
+                static constexpr uint32_t       SLOT_MASK = SLOTS_NUM - 1;
+                static constexpr uint32_t       LEVELS_NUM = 4;                 // Number of levels of the wheel
+                static constexpr uint32_t       NULL_NODE = UINT32_MAX;
+
+                struct TimerNode {
+                        int             x;
+                        int             y;
+                        uint64_t        targetTick;     // Tick at which the block must be updated
+                        BlockType       block;
+                        uint8_t         level;          // Level of the wheel that contains the node
+                        uint8_t         slot;           // Slot (of the level) that contains the node
+                        uint32_t        prev;           // Previous node in the same slot
+                        uint32_t        next;           // Next node in the same slot
+                        uint32_t        chunkPrev;      // Previous node in the same chunk
+                        uint32_t        chunkNext;      // Next node in the same chunk
+                };
+
+                void                    insertNode(uint32_t nodeId);
+                void                    unlinkNode(uint32_t nodeId);
+                void                    freeNode(uint32_t nodeId);
+                void                    cascade(uint32_t level);
+
+                static inline uint64_t  packPos(int x, int y)                   { return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y; }
+
+                uint64_t                                m_currTick;                     // The next tick that will be processed
+                uint32_t                                m_slots[LEVELS_NUM][SLOTS_NUM]; // First node of each slot of the wheel
+                std::vector<TimerNode>                  m_nodes;                        // Pool of nodes, indexes are stable
+                std::vector<uint32_t>                   m_freeNodes;                    // Nodes of the pool that can be reused
+                std::unordered_map<uint64_t, uint32_t>  m_nodesByPos;                   // Node pending for each block position
+                std::unordered_map<int, uint32_t>       m_chunkHeads;                   // First node of each chunk
+        };
+
+}
+
+#endif // TICK_SCHEDULER_H
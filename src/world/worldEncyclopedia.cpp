@@ -167,247 +167,261 @@ namespace mc2d {
 
 // ============================== [ Blocks properties look-up table ] ==============================
 
+        // Each entry is defined as: { collidable, hardness, light emission, light opacity, random ticks, gravity }
         const BlockProperties WorldEncyclopedia::s_blockPropsLUT[] = {
 
                 // GRASS
-                { true, 2 },
+                { true, 2, 0, 15, true, false },
 
                 // DIRT
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // STONE
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // COBBLESTONE
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // GRAVEL
-                { true, 2 },
+                { true, 2, 0, 15, false, true },
 
                 // MICELIUM
-                { true, 2 },
+                { true, 2, 0, 15, true, false },
 
                 // SAND
-                { true, 2 },
+                { true, 2, 0, 15, false, true },
 
                 // SANDSTONE_RAW
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // SANDSTONE
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // SANDSTONE_POLISHED
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // GRASS_SNOW
-                { true, 2 },
+                { true, 2, 0, 15, true, false },
 
                 // SNOW
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // ICE
-                { true, 2 },
+                { true, 2, 0, 2, false, false },
 
                 // CLAY
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // OBSIDIAN
-                { true, 8 },
+                { true, 8, 0, 15, false, false },
 
                 // BEDROCK
-                { true, 255 },
+                { true, 255, 0, 15, false, false },
 
 
                 // ===========================[ Wood and trees ]=========================== 
                 // OAK_WOOD
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // OAK_LEAF
-                { true, 2 },
+                { true, 2, 0, 1, true, false },
 
                 // OAK_PLANK
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // OAK_SAPLING
-                { true, 0 },
+                { true, 0, 0, 0, false, false },
 
                 // BIRCH_WOOD
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // BIRCH_LEAF
-                { true, 2 },
+                { true, 2, 0, 1, true, false },
 
                 // BIRCH_PLANK
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // BIRCH_SAPLING
-                { true, 0 },
+                { true, 0, 0, 0, false, false },
 
                 // JUNGLE_WOOD
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // JUNGLE_LEAF
-                { true, 2 },
+                { true, 2, 0, 1, true, false },
 
                 // JUNGLE_PLANK
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // JUNGLE_SAPLING
-                { true, 0 },
+                { true, 0, 0, 0, false, false },
 
                 // SPRUCE_WOOD
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // SPRUCE_LEAF
-                { true, 2 },
+                { true, 2, 0, 1, true, false },
 
                 // SPRUCE_PLANK
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // SPRUCE_SAPLING
-                { true, 0 },
+                { true, 0, 0, 0, false, false },
 
                 // ===========================[ Minerals ]=========================== 
                 // COAL_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // COAL_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // IRON_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // IRON_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // GOLD_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // GOLD_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // DIAMOND_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // DIAMOND_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // EMERALD_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // EMERALD_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // REDSTONE_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // REDSTONE_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // LAPISLAZZUILI_ORE
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // LAPISLAZZUILI_BLOCK
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
 
                 // ===========================[ Others ]=========================== 
                 // MOSSY_COBBLESTONE
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // MOSSY_BRICK
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
 
                 // ===========================[ Furnitures ]=========================== 
                 // WORKBENCH
-                { false, 2 },
+                { false, 2, 0, 15, false, false },
 
                 // FURNACE
-                { false, 3 },
+                { false, 3, 0, 15, false, false },
 
                 // FURNACE_ACTIVE
-                { false, 3 },
+                { false, 3, 13, 15, false, false },
 
                 // CHEST
-                { false, 2 },
+                { false, 2, 0, 15, false, false },
 
                 // DOOR_OPEN_LOW
-                { false, 2 },
+                { false, 2, 0, 0, false, false },
 
                 // DOOR_OPEN_HIGH
-                { false, 2 },
+                { false, 2, 0, 0, false, false },
 
                 // DOOR_CLOSED
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // TRAP_OPEN
-                { false, 2 },
+                { false, 2, 0, 0, false, false },
 
                 // TRAP_CLOSED
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // STAIR
-                { false, 2 },
+                { false, 2, 0, 15, false, false },
 
                 // BED_END
-                { false, 2 },
+                { false, 2, 0, 0, false, false },
 
                 // BED_START
-                { false, 2 },
+                { false, 2, 0, 0, false, false },
 
 
                 // ===========================[ Others ]=========================== 
                 // TNT
-                { true, 0 },
+                { true, 0, 0, 15, false, false },
 
                 // WOOL
-                { true, 2 },
+                { true, 2, 0, 15, false, false },
 
                 // PISTON
-                { true, 3 },
+                { true, 3, 0, 15, false, false },
 
                 // ENCHANTMENT_BENCH
-                { false, 3 },
+                { false, 3, 0, 15, false, false },
 
                 
                 // BRICK
-                { true, 4 },
+                { true, 4, 0, 15, false, false },
 
                 // GLASS
-                { true, 2 },
+                { true, 2, 0, 0, false, false },
 
                 // LIBRARY
-                { false, 3 },
+                { false, 3, 0, 15, false, false },
 
                 // FLOWER_RED
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
 
                 // FLOWER_YELLOW
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
 
                 // SHRUB
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
 
                 // MUSHROOM_RED
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
 
                 // MUSHROOM_BROWN
-                { false, 0 },
+                { false, 0, 1, 0, false, false },
 
 
                 // ===========================[ Liquids ]=========================== 
                 // WATER
-                { true, 0 },
+                { false, 0, 0, 2, false, false },
 
                 // LAVA
-                { true, 0 },
+                { false, 0, 15, 2, false, false },
 
                 // AIR
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
 
                 // BLOCK_TYPE_MAX (same as AIR block properties)
-                { false, 0 },
+                { false, 0, 0, 0, false, false },
+        };
+
+
+// ============================== [ Entity properties look-up table ] ==============================
+
+        // Each entry is defined as: { width, height, gravity }
+        const EntityProperties WorldEncyclopedia::s_entityPropsLUT[] = {
+
+                // PLAYER
+                { 0.5f, 0.5f, true },
+
+                // CHICKEN
+                { 0.5f, 0.5f, true },
         };
 
 }
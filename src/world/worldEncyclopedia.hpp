@@ -14,6 +14,7 @@
 
 #include "blockTypes.hpp"
 #include "biomeTypes.hpp"
+#include "entity.hpp"
 
 namespace mc2d {
 
@@ -69,6 +70,18 @@ namespace mc2d {
         struct BlockProperties {
                 bool                    collidable;
                 uint32_t                hardness;
+                uint8_t                 lightEmission;                  // Light level emitted by the block (0 means that the block is not a light source)
+                uint8_t                 lightOpacity;                   // Amount of light absorbed by the block (MAX_LIGHT_LEVEL means that the block is opaque)
+                bool                    randomTicks;                    // True if the block reacts to random ticks (grass spread, leaf decay, ...)
+                bool                    gravity;                        // True if the block falls when there is nothing below it
+        };
+
+
+        // Defines all the properties of a certain entity type
+        struct EntityProperties {
+                float                   width;                          // Size of the collision box of the entity (measured in blocks), the
+                float                   height;                         // position of the entity is the bottom left corner of the box
+                bool                    gravity;                        // True if the entity falls when there is nothing below it
         };
 
 
@@ -80,12 +93,14 @@ namespace mc2d {
                 static inline const BiomeProperties&    getBiomeProperties(const BiomeType type)        { return s_biomePropsLUT[ static_cast<uint32_t>(type) ]; }
                 static inline const TreeProperties&     getTreeProperties(const TreeType type)          { return s_treePropsLUT[ static_cast<uint32_t>(type) ]; }
                 static inline const BlockProperties&    getBlockProperties(const BlockType type)        { return s_blockPropsLUT[ static_cast<uint32_t>(type) ]; }
+                static inline const EntityProperties&   getEntityProperties(const EntityType type)      { return s_entityPropsLUT[ static_cast<uint32_t>(type) ]; }
 
         private:
 
                 static const BiomeProperties    s_biomePropsLUT[];
                 static const TreeProperties     s_treePropsLUT[];
                 static const BlockProperties    s_blockPropsLUT[];
+                static const EntityProperties   s_entityPropsLUT[];
         };
 
 
@@ -86,11 +86,12 @@ namespace mc2d {
                 // Retrieve biome properties
                 const BiomeProperties& biomeProps = WorldEncyclopedia::getBiomeProperties(biome);
 
-                // Generate random terrain for the chunk
-                Terrain t = generateRandomTerrain(gen, Chunk::width, Chunk::height, biomeProps);
+                // Generate random terrain for the chunk (in a scratch terrain that keeps its memory from one chunk to the next one)
+                static Terrain t = {};
+                generateRandomTerrain(gen, Chunk::width, Chunk::height, biomeProps, t);
 
                 // Add stuff to the terrain
-                //addWaterToTerrain(gen, t, biomeProps);
+                addWaterToTerrain(gen, t, biomeProps);
                 //addTreesToTerrain(gen, t, biomeProps);
                 //addMineralsToTerrain(gen, t, biomeProps);
 
@@ -113,6 +114,7 @@ namespace mc2d {
 
                 const BiomeProperties& biomeProps = WorldEncyclopedia::getBiomeProperties(BiomeType::SUPER_FLAT);
 
+                newChunk.blocks = ChunkBufferPool::acquireBlocks();
                 newChunk.blocks.resize(Chunk::width * Chunk::height, BlockType::AIR);
                 uint32_t offset = ((Chunk::height / 2) * Chunk::width) * sizeof(BlockType);
 
@@ -146,16 +148,18 @@ namespace mc2d {
         // @width: the width of terrain
         // @height: the height of terrain
         // @biome: specify the properties and the constraints that the generated terrain must have
-        // @returns: the generated terrain
+        // @t: terrain in which the generated one is written (its arrays are reused, the blocks are taken from the ChunkBufferPool if it has none)
         // (Note: terrain generation uses a linear interpolation of terrain control points, those points are distributed 
         // equally on the x axis and pseudo randomly on the y axis(even if y is bound in range [minTerrainHeight, maxTerrainHeight]))
-        WorldGenerator::Terrain WorldGenerator::generateRandomTerrain(RNG& rng, size_t width, size_t height, const BiomeProperties& biome)
+        void WorldGenerator::generateRandomTerrain(RNG& rng, size_t width, size_t height, const BiomeProperties& biome, Terrain& t)
         {
-                Terrain t = {};
+                if(t.blocks.capacity() == 0)
+                        t.blocks = ChunkBufferPool::acquireBlocks();
+
                 t.width = width;
                 t.height = height;
-                t.terrainHeightValues.resize(width, 0);
-                t.blocks.resize(width * height, BlockType::AIR);
+                t.terrainHeightValues.assign(width, 0);
+                t.blocks.assign(width * height, BlockType::AIR);
 
                 std::uniform_int_distribution heightDistrib(biome.minTerrainHeight, biome.maxTerrainHeight);
                 std::uniform_real_distribution slopeDistrib(biome.minTerrainSlope, biome.maxTerrainSlope);
@@ -211,8 +215,6 @@ namespace mc2d {
 
                 // Add final bedrock layer
                 std::memset(&(t.blocks[ (t.height - 1) * t.width ]), (uint8_t) BlockType::BEDROCK, t.width * sizeof(BlockType));
-
-                return t;
         }
 
 
@@ -222,9 +224,38 @@ namespace mc2d {
         }
 
 
+        // Adds a small lake in the lowest part of the given terrain (with a probability that depends on the biome)
+        // @rng: pseudo random number generator to be used
+        // @t: the terrain to which the lake will be added
+        // @biome: defines the probability of spawning water
         void WorldGenerator::addWaterToTerrain(RNG& rng, Terrain& t, const BiomeProperties& biome)
         {
-                // TODO: Add implementation...
+                std::uniform_real_distribution<float> spawnDistrib(0.0f, 1.0f);
+                if(t.width == 0 || spawnDistrib(rng) >= biome.waterSpawnProbability)
+                        return;
+
+                // The lowest terrain column is the one with the greatest y index
+                size_t lakeX = std::distance(t.terrainHeightValues.begin(), std::max_element(t.terrainHeightValues.begin(), t.terrainHeightValues.end()));
+                size_t surfaceY = t.terrainHeightValues[lakeX];
+
+                // The lake extends to all the adjacent columns that are not higher than its surface
+                size_t firstX = lakeX;
+                size_t lastX = lakeX;
+
+                while(firstX > 0 && t.terrainHeightValues[firstX - 1] >= surfaceY)
+                        --firstX;
+
+                while(lastX + 1 < t.width && t.terrainHeightValues[lastX + 1] >= surfaceY)
+                        ++lastX;
+
+                // Replace the superficial blocks with water, inner columns are one block deeper than the shores
+                for(size_t x = firstX; x <= lastX; ++x)
+                {
+                        size_t bottomY = t.terrainHeightValues[x] + (x != firstX && x != lastX ? 1 : 0);
+
+                        for(size_t y = surfaceY; y <= bottomY && y < t.height - 1; ++y)
+                                t.blocks[(y * t.width) + x] = BlockType::WATER;
+                }
         }
 
 
@@ -40,7 +40,7 @@ namespace mc2d {
 
                 using RNG = std::mt19937;
 
-                static Terrain          generateRandomTerrain(RNG& rng, size_t width, size_t height, const BiomeProperties& biome);
+                static void             generateRandomTerrain(RNG& rng, size_t width, size_t height, const BiomeProperties& biome, Terrain& t);
                 static void             addTreesToTerrain(RNG& rng, Terrain& t, const BiomeProperties& biome);
                 static void             addWaterToTerrain(RNG& rng, Terrain& t, const BiomeProperties& biome);
                 static void             addMineralsToTerrain(RNG& rng, Terrain& t, const BiomeProperties& biome);
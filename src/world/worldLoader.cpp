@@ -1,6 +1,12 @@
 
 #include "worldLoader.hpp"
 #include "worldGenerator.hpp"
+#include "blockJournal.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 
 namespace mc2d {
 
@@ -28,8 +34,9 @@ namespace mc2d {
                         return false;
                 }
 
+                // The journal is read before the chunks get loaded, so that the edits that are not in their files are replayed
                 world.setWorldSaveDirectory(worldDirPath);
-                bool res = world.deserialize(worldFile);
+                bool res = loadJournal(worldDirPath, world.m_blockJournal) && world.deserialize(worldFile);
 
                 worldFile.close();
                 return res;
@@ -53,13 +60,14 @@ namespace mc2d {
                         std::filesystem::create_directory(worldDirPath);
 
                 std::filesystem::path worldFilePath = worldDirPath / getWorldFilename();
+                std::filesystem::path tempFilePath = getTempFilePath(worldFilePath);
 
-                // Try to open "world.dat" file and write content into it
+                // Try to open a temporary "world.dat" file and write content into it
                 std::ofstream worldFile;
-                worldFile.open(worldFilePath, std::ios::binary | std::ios::trunc);
+                worldFile.open(tempFilePath, std::ios::binary | std::ios::trunc);
                 if(!worldFile.is_open())
                 {
-                        logError("WorldLoader::saveWorld() failed, cannot open \"%s\" file!", worldFilePath.c_str())
+                        logError("WorldLoader::saveWorld() failed, cannot open \"%s\" file!", tempFilePath.c_str())
                         return false;
                 }
 
@@ -67,7 +75,13 @@ namespace mc2d {
                 bool res = world.serialize(worldFile);
 
                 worldFile.close();
-                return res;
+                if(!res || worldFile.fail())
+                {
+                        std::filesystem::remove(tempFilePath);
+                        return false;
+                }
+
+                return commitFile(tempFilePath, worldFilePath);
         }
 
 
@@ -114,19 +128,177 @@ namespace mc2d {
                 }
 
                 std::filesystem::path chunkFilePath = worldDirPath / getChunkFilename(chunk.id);
+                std::filesystem::path tempFilePath = getTempFilePath(chunkFilePath);
 
-                // Try to open "..worldDirPath../chunkX.dat" file and write content into it
+                // Try to open a temporary "..worldDirPath../chunkX.dat" file and write content into it
                 std::ofstream chunkFile;
-                chunkFile.open(chunkFilePath, std::ios::binary | std::ios::trunc);
+                chunkFile.open(tempFilePath, std::ios::binary | std::ios::trunc);
                 if(!chunkFile.is_open())
                 {
-                        logError("WorldLoader::saveChunk() failed, cannot open \"%s\" file!", chunkFilePath.c_str())
+                        logError("WorldLoader::saveChunk() failed, cannot open \"%s\" file!", tempFilePath.c_str())
                         return false;
                 }
 
                 bool res = chunk.serialize(chunkFile);
                 chunkFile.close();
+                if(!res || chunkFile.fail())
+                {
+                        std::filesystem::remove(tempFilePath);
+                        return false;
+                }
+
+                return commitFile(tempFilePath, chunkFilePath);
+        }
+
+
+        // Loads the block journal of a game world from the filesystem (a world without journal gets an empty one)
+        // @worldDirPath: path to the directory that contains the world data
+        // @journal: BlockJournal instance in which the data loaded will be stored
+        // @returns: true if the journal gets loaded correctly, false otherwise
+        bool WorldLoader::loadJournal(const std::filesystem::path& worldDirPath, BlockJournal& journal)
+        {
+                if(worldDirPath.empty())
+                {
+                        logError("WorldLoader::loadJournal() failed, the path to the directory from which the journal should be loaded is empty!");
+                        return false;
+                }
+
+                std::filesystem::path journalFilePath = worldDirPath / getJournalFilename();
+                if(!std::filesystem::exists(journalFilePath))
+                {
+                        journal.clear();
+                        return true;
+                }
+
+                // Try to open "..worldDirPath../journal.dat" file and deserialize its content
+                std::ifstream journalFile;
+                journalFile.open(journalFilePath, std::ios::binary);
+                if(!journalFile.is_open())
+                {
+                        logError("WorldLoader::loadJournal() failed, cannot open \"%s\" file!", journalFilePath.c_str())
+                        return false;
+                }
+
+                bool res = journal.deserialize(journalFile);
+                journalFile.close();
+                return res;
+        }
+
+
+        // Writes a batch of records of the block journal of a game world in its file: they are appended to the file, or the
+        // file is rewritten with them if the batch requires it (called by the ChunkWriter thread, see BlockJournal::takeNewRecords())
+        // @worldDirPath: path to the directory that contains the world data
+        // @batch: the records to write
+        // @returns: true if the records are on disk, false otherwise (the next batch must rewrite the file)
+        bool WorldLoader::appendJournal(const std::filesystem::path& worldDirPath, const JournalBatch& batch)
+        {
+                if(worldDirPath.empty())
+                {
+                        logError("WorldLoader::appendJournal() failed, the path to the directory in which the journal should be saved is empty!");
+                        return false;
+                }
+
+                if(batch.rewrite)
+                        return saveJournal(worldDirPath, batch);
+
+                // Records appended to a missing file would have no header
+                std::filesystem::path journalFilePath = worldDirPath / getJournalFilename();
+                if(!std::filesystem::exists(journalFilePath))
+                {
+                        logError("WorldLoader::appendJournal() failed, \"%s\" file does not exist!", journalFilePath.c_str())
+                        return false;
+                }
+
+                // Try to open "..worldDirPath../journal.dat" file and append the new records to it
+                std::ofstream journalFile;
+                journalFile.open(journalFilePath, std::ios::binary | std::ios::app);
+                if(!journalFile.is_open())
+                {
+                        logError("WorldLoader::appendJournal() failed, cannot open \"%s\" file!", journalFilePath.c_str())
+                        return false;
+                }
+
+                bool res = BlockJournal::serialize(journalFile, batch);
+                journalFile.close();
+                return res && !journalFile.fail() && syncFile(journalFilePath);
+        }
+
+
+        // Rewrites the whole block journal of a game world on the filesystem
+        // @worldDirPath: path to the directory that contains the world data
+        // @batch: all the records of the journal
+        // @returns: true if the journal gets saved correctly, false otherwise
+        bool WorldLoader::saveJournal(const std::filesystem::path& worldDirPath, const JournalBatch& batch)
+        {
+                std::filesystem::path journalFilePath = worldDirPath / getJournalFilename();
+                std::filesystem::path tempFilePath = getTempFilePath(journalFilePath);
+
+                // Try to open a temporary "..worldDirPath../journal.dat" file and write content into it
+                std::ofstream journalFile;
+                journalFile.open(tempFilePath, std::ios::binary | std::ios::trunc);
+                if(!journalFile.is_open())
+                {
+                        logError("WorldLoader::saveJournal() failed, cannot open \"%s\" file!", tempFilePath.c_str())
+                        return false;
+                }
+
+                bool res = BlockJournal::serialize(journalFile, batch);
+                journalFile.close();
+                if(!res || journalFile.fail())
+                {
+                        std::filesystem::remove(tempFilePath);
+                        return false;
+                }
+
+                return commitFile(tempFilePath, journalFilePath);
+        }
+
+
+        // Replaces a file with a temporary file that contains its new content, the new content is synced to disk before the
+        // rename so after a crash the file contains either the old or the new content
+        // @tempFilePath: path to the temporary file (it is removed if the replacement fails)
+        // @filePath: path to the file that must be replaced
+        // @returns: true if the file has been replaced, false otherwise
+        bool WorldLoader::commitFile(const std::filesystem::path& tempFilePath, const std::filesystem::path& filePath)
+        {
+                if(!syncFile(tempFilePath))
+                {
+                        logError("WorldLoader::commitFile() failed, cannot sync \"%s\" file to disk!", tempFilePath.c_str());
+                        std::filesystem::remove(tempFilePath);
+                        return false;
+                }
+
+                std::error_code error;
+                std::filesystem::rename(tempFilePath, filePath, error);
+                if(error)
+                {
+                        logError("WorldLoader::commitFile() failed, cannot rename \"%s\" file!", tempFilePath.c_str());
+                        std::filesystem::remove(tempFilePath);
+                        return false;
+                }
+
+                // The rename is on disk only once the directory that contains the file has been synced too
+                syncFile(filePath.parent_path());
+                return true;
+        }
+
+
+        // Waits until the content of a file (or of a directory) is on disk
+        // @path: path to the file or directory
+        // @returns: true on success, false otherwise
+        bool WorldLoader::syncFile(const std::filesystem::path& path)
+        {
+#ifdef __linux__
+                int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if(fd < 0)
+                        return false;
+
+                bool res = fsync(fd) == 0;
+                close(fd);
                 return res;
+#else
+                return true;
+#endif
         }
 
 
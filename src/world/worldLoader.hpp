@@ -5,6 +5,10 @@
 // Each game world (save game) is saved in it's own directory, each directory contains:
 //      - one "world.dat" file: this file contains gloabl information about the game world
 //      - N "chunkX.dat" files: a file of this type contains data about the chunk with id X
+//      - one "journal.dat" file: the block edits made after the chunk files have been written (see BlockJournal)
+//
+// Files are never rewritten in place: they are written in a temporary file that is synced to disk and then renamed over
+// the old one, so a crash in the middle of a save leaves the old file intact.
 //
 
 #ifndef WORLD_LOADER_H
@@ -19,6 +23,8 @@
 namespace mc2d {
 
         class GameWorld;
+        class BlockJournal;
+        struct JournalBatch;
         struct Chunk;
 
         class WorldLoader {
@@ -32,12 +38,21 @@ namespace mc2d {
                 static bool             loadChunk(const std::filesystem::path& worldDirPath, int chunkId, Chunk& chunk);
                 static bool             saveChunk(const std::filesystem::path& worldDirPath, const Chunk& chunk);
 
+                static bool             loadJournal(const std::filesystem::path& worldDirPath, BlockJournal& journal);
+                static bool             appendJournal(const std::filesystem::path& worldDirPath, const JournalBatch& batch);
+
                 static std::string      createDummyWorldName();
 
         private:
 
                 static inline std::filesystem::path     getWorldFilename()              { return std::filesystem::path("world.dat"); }
                 static inline std::filesystem::path     getChunkFilename(int chunkId)   { return std::filesystem::path("chunk" + std::to_string(chunkId) + ".dat"); }
+                static inline std::filesystem::path     getJournalFilename()            { return std::filesystem::path("journal.dat"); }
+                static inline std::filesystem::path     getTempFilePath(const std::filesystem::path& filePath) { return std::filesystem::path(filePath.string() + ".tmp"); }
+
+                static bool             saveJournal(const std::filesystem::path& worldDirPath, const JournalBatch& batch);
+                static bool             commitFile(const std::filesystem::path& tempFilePath, const std::filesystem::path& filePath);
+                static bool             syncFile(const std::filesystem::path& path);
 
         };
 
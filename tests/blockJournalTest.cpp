@@ -0,0 +1,71 @@
+// Checks the writes of the block journal, which are done by the ChunkWriter thread: the records handed over by the autosave
+// must reach the journal file, a compaction must rewrite the file with the records that are left and a failed write must be
+// reported by the next autosave, which rewrites the whole file.
+//
+
+#include <filesystem>
+#include <cstdio>
+
+#include "world/gameWorld.hpp"
+#include "world/worldGenerator.hpp"
+#include "world/worldLoader.hpp"
+
+using namespace mc2d;
+
+
+static int s_failures = 0;
+
+
+static void check(bool condition, const char* what)
+{
+        std::printf("%s: %s\n", condition ? "ok    " : "FAILED", what);
+        s_failures += !condition;
+}
+
+
+// Returns the number of records in the journal file of the world
+static size_t getRecordsOnDisk(const std::filesystem::path& worldDirPath)
+{
+        BlockJournal journal;
+        return WorldLoader::loadJournal(worldDirPath, journal) ? journal.getRecordsNum() : 0;
+}
+
+
+int main()
+{
+        const std::filesystem::path worldDirPath = std::filesystem::temp_directory_path() / "mc2dBlockJournalTest";
+        std::filesystem::remove_all(worldDirPath);
+        std::filesystem::create_directories(worldDirPath);
+
+        GameWorld world = WorldGenerator::generateFlatWorld(5);
+        world.setWorldSaveDirectory(worldDirPath);
+        world.update();
+
+        const int y = Chunk::height - 1;
+        world.applyBlockEdits( { { 1, y, BlockType::STONE }, { 2, y, BlockType::STONE }, { 3, y, BlockType::STONE } } );
+        check(world.syncBlockJournal(), "the autosave hands the records over");
+        check(world.flushChunkWrites(), "the records have been written");
+        check(getRecordsOnDisk(worldDirPath) == 3, "the journal file contains the records");
+
+        // The records before the save are dropped, the file is rewritten with the others
+        const uint64_t savedSeq = world.getBlockJournal().getNextSeq();
+        world.applyBlockEdits( { { 4, y, BlockType::STONE }, { 5, y, BlockType::STONE } } );
+        check(world.compactBlockJournal(savedSeq), "the compaction hands the records over");
+        check(world.flushChunkWrites(), "the compacted journal has been written");
+        check(getRecordsOnDisk(worldDirPath) == 2, "the journal file contains only the records after the save");
+
+        // Records cannot be appended to a missing file, the failure is reported by the next autosave
+        std::filesystem::remove(worldDirPath / "journal.dat");
+        world.applyBlockEdits( { { 6, y, BlockType::STONE } } );
+        world.syncBlockJournal();
+        check(!world.flushChunkWrites(), "appending to a missing journal file fails");
+
+        world.applyBlockEdits( { { 7, y, BlockType::STONE } } );
+        check(!world.syncBlockJournal(), "the next autosave reports the failure");
+        check(world.flushChunkWrites(), "the journal has been rewritten");
+        check(getRecordsOnDisk(worldDirPath) == world.getBlockJournal().getRecordsNum(), "the rewritten file contains all the records");
+
+        std::error_code error;
+        std::filesystem::remove_all(worldDirPath, error);
+        return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Checks that GameWorld::flushChunkWrites() writes all the chunks that are not loaded: the chunks kept in the chunk cache
+// (with the edits made before they got unloaded) and the chunks in which entities have been parked, which are not loaded
+// at all. After the flush the chunk files must contain them and nothing must be left in memory.
+//
+
+#include <filesystem>
+#include <cstdio>
+
+#include "world/gameWorld.hpp"
+#include "world/worldGenerator.hpp"
+#include "world/worldLoader.hpp"
+
+using namespace mc2d;
+
+
+static int s_failures = 0;
+
+
+static void check(bool condition, const char* what)
+{
+        std::printf("%s: %s\n", condition ? "ok    " : "FAILED", what);
+        s_failures += !condition;
+}
+
+
+// Moves the main player (one chunk at a time, so that the chunks on its way get loaded) to the given column
+static void movePlayer(GameWorld& world, float x)
+{
+        EntityStore& entities = world.getEntities();
+        EntityHandle player = world.getMainPlayer();
+
+        while(std::abs(entities.getPos(player).x - x) > 1.0f)
+        {
+                const float step = std::clamp(x - entities.getPos(player).x, -(float) Chunk::width, (float) Chunk::width);
+                entities.setPos(player, glm::vec3(entities.getPos(player).x + step, Chunk::height - 2.0f, 0.0f));
+                entities.setVelocity(player, glm::vec3(0.0f));
+                world.update();
+        }
+
+        world.update();
+}
+
+
+int main()
+{
+        const std::filesystem::path worldDirPath = std::filesystem::temp_directory_path() / "mc2dChunkFlushTest";
+        std::filesystem::remove_all(worldDirPath);
+        std::filesystem::create_directories(worldDirPath);
+
+        GameWorld world = WorldGenerator::generateFlatWorld(5);
+        world.setWorldSaveDirectory(worldDirPath);
+
+        ChunkStreamingSettings settings;
+        settings.prefetchTime = 0.0f;
+        world.setChunkStreamingSettings(settings);
+        movePlayer(world, Chunk::width / 2.0f);
+
+        // A block edited in a chunk that then stays in the cache
+        const int editX = 2;
+        const int editY = Chunk::height - 1;
+        world.setBlock(editX + 0.5f, editY + 0.5f, BlockType::STONE);
+
+        // An entity moved to a chunk that is not loaded gets parked
+        const int parkedId = 20;
+        EntityHandle chicken = world.addEntity(Entity(glm::vec3(Chunk::width / 2.0f, Chunk::height - 2.0f, 0.0f), 50.0f, EntityType::CHICKEN));
+        check(chicken != INVALID_ENTITY_HANDLE, "the entity is added to the ticking chunk");
+        world.getEntities().setPos(chicken, glm::vec3(parkedId * Chunk::width + 4.0f, Chunk::height - 2.0f, 0.0f));
+        world.update();
+        check(!world.getEntities().isValid(chicken), "the entity has left the entity store (it is parked)");
+
+        movePlayer(world, -8.0f * Chunk::width);
+        check(world.getLoadedChunks().find(0) == world.getLoadedChunks().end(), "the edited chunk has been unloaded");
+        check(world.getChunkCache().getChunksNum() > 0, "the unloaded chunks are kept in the cache");
+
+        check(world.flushChunkWrites(), "the chunks have been written");
+        check(world.getChunkCache().getChunksNum() == 0, "no chunk is left in the cache");
+
+        Chunk edited;
+        const bool editedLoaded = WorldLoader::loadChunk(worldDirPath, 0, edited);
+        check(editedLoaded, "the cached chunk has a file");
+        check(editedLoaded && edited.blocks[(Chunk::height - 1 - editY) * Chunk::width + editX] == BlockType::STONE, "the file of the cached chunk contains the edit");
+
+        Chunk parked;
+        check(WorldLoader::loadChunk(worldDirPath, parkedId, parked), "the chunk of the parked entity has a file");
+        check(parked.entities.size() == 1, "the file of the chunk contains the parked entity");
+
+        std::error_code error;
+        std::filesystem::remove_all(worldDirPath, error);
+        return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Checks the snapshots of the chunks (see ChunkSnapshot): a snapshot taken before an edit must not change when the chunk
+// gets edited, the next snapshot must contain the edit (and the light updated by it) and taking a snapshot of a chunk that
+// has not changed must return the same snapshot.
+//
+
+#include <cstdio>
+
+#include "world/gameWorld.hpp"
+#include "world/worldGenerator.hpp"
+
+using namespace mc2d;
+
+
+static int s_failures = 0;
+
+
+static void check(bool condition, const char* what)
+{
+        std::printf("%s: %s\n", condition ? "ok    " : "FAILED", what);
+        s_failures += !condition;
+}
+
+
+// Returns true if the snapshot contains the same blocks, fluid and light levels of the chunk
+static bool matchesChunk(const ChunkSnapshot& snapshot, const Chunk& chunk)
+{
+        return snapshot.id == chunk.id && snapshot.blocks == chunk.blocks && snapshot.fluidLevels == chunk.fluidLevels &&
+                snapshot.skyLight == chunk.skyLight && snapshot.blockLight == chunk.blockLight;
+}
+
+
+int main()
+{
+        GameWorld world = WorldGenerator::generateFlatWorld(5);
+        world.update();
+
+        const Chunk& chunk = world.getLoadedChunks().at(0);
+        const int x = 3;
+        const int y = Chunk::height - 1;
+
+        std::shared_ptr<const ChunkSnapshot> before = world.getChunkSnapshot(0);
+        check(before != nullptr && matchesChunk(*before, chunk), "the snapshot is a copy of the chunk");
+        if(before == nullptr)
+                return 1;
+
+        check(world.getChunkSnapshot(0) == before, "the snapshot of a chunk that has not changed is shared");
+
+        const BlockType oldBlock = before->getBlock(x, y);
+        const std::vector<uint8_t> oldSkyLight = before->skyLight;
+        world.setBlock(x + 0.5f, y + 0.5f, BlockType::STONE);
+        world.update();
+
+        check(before->getBlock(x, y) == oldBlock && before->getBlock(x, y) != BlockType::STONE, "the old snapshot keeps the old block");
+        check(before->skyLight == oldSkyLight, "the old snapshot keeps the old light");
+
+        std::shared_ptr<const ChunkSnapshot> after = world.getChunkSnapshot(0);
+        check(after != before, "the edit drops the snapshot of the chunk");
+        check(after->getBlock(x, y) == BlockType::STONE, "the new snapshot contains the edit");
+        check(matchesChunk(*after, chunk), "the new snapshot contains the light updated by the edit");
+
+        check(world.getChunkSnapshot(1000) == nullptr, "chunks that are not loaded have no snapshot");
+        return s_failures == 0 ? 0 : 1;
+}
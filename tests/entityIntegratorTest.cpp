@@ -0,0 +1,132 @@
+
+// Checks that each kernel of the EntityIntegrator computes exactly (bit by bit) the positions, velocities and accelerations
+// computed by Entity::update() on the same entities (the kernels not supported by the cpu are skipped). The counts of
+// entities include the ones that are not a multiple of the width of the vectors, so the entities left over by the vectorized
+// loops are checked too.
+//
+
+#include <vector>
+#include <random>
+#include <cstring>
+#include <cstdio>
+
+#include "entityIntegrator.hpp"
+#include "entity.hpp"
+
+using namespace mc2d;
+
+
+static constexpr int    STEPS_NUM = 64;                 // Number of integration steps executed on the same entities
+static constexpr float  STEP_DURATION = 50.0f / 3.0f;   // Duration of a step (in milliseconds, like the simulation steps)
+
+
+// One axis of the entities, stored like in the entity store
+struct Axis {
+        std::vector<float>      pos;
+        std::vector<float>      vel;
+        std::vector<float>      acc;
+};
+
+
+// Creates entities with random values, some velocities are close to ENTITY_MIN_VELOCITY so that they get zeroed by the drag
+static std::vector<Entity> createEntities(size_t num, unsigned seed)
+{
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> values(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> smallValues(-2.0f * ENTITY_MIN_VELOCITY, 2.0f * ENTITY_MIN_VELOCITY);
+
+        std::vector<Entity> entities;
+        for(size_t i = 0; i < num; ++i)
+        {
+                Entity e(glm::vec3(values(rng), values(rng), 0.0f), 100.0f, EntityType::CHICKEN);
+                e.setVelocity(glm::vec3(i % 5 == 0 ? smallValues(rng) : values(rng), values(rng), 0.0f));
+                entities.push_back(e);
+        }
+
+        return entities;
+}
+
+
+// Returns true if the two values have the same bits
+static bool isSame(float a, float b)
+{
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+
+// Runs the given kernel and Entity::update() on the same entities and compares the results
+// @returns: the number of entities whose values differ
+static size_t compareKernel(IntegrationKernel kernel, size_t num, unsigned seed)
+{
+        std::vector<Entity> expected = createEntities(num, seed);
+        Axis x, y;
+        for(const Entity& e : expected)
+        {
+                x.pos.push_back(e.getPos().x);
+                x.vel.push_back(e.getVelocity().x);
+                y.pos.push_back(e.getPos().y);
+                y.vel.push_back(e.getVelocity().y);
+        }
+
+        x.acc.resize(num);
+        y.acc.resize(num);
+
+        EntityIntegrator::setKernel(kernel);
+        for(int s = 0; s < STEPS_NUM; ++s)
+        {
+                // New accelerations each step (the updates reset them to zero)
+                for(size_t i = 0; i < num; ++i)
+                {
+                        x.acc[i] = (float) ((i * 7 + s * 13) % 19) - 9.0f;
+                        y.acc[i] = (i + s) % 3 == 0 ? 0.0f : -9.8f;
+                        expected[i].setAcceleration(glm::vec3(x.acc[i], y.acc[i], 0.0f));
+                        expected[i].update(STEP_DURATION);
+                }
+
+                // The entity store converts the duration of the step in the same way
+                const float deltaTimeInSec = STEP_DURATION / 1000.0f;
+                EntityIntegrator::integrate(x.pos.data(), x.vel.data(), x.acc.data(), num, deltaTimeInSec);
+                EntityIntegrator::integrate(y.pos.data(), y.vel.data(), y.acc.data(), num, deltaTimeInSec);
+        }
+
+        size_t differences = 0;
+        for(size_t i = 0; i < num; ++i)
+        {
+                const Entity& e = expected[i];
+                differences += !isSame(e.getPos().x, x.pos[i]) || !isSame(e.getVelocity().x, x.vel[i]) || !isSame(e.getAcceleration().x, x.acc[i]) ||
+                        !isSame(e.getPos().y, y.pos[i]) || !isSame(e.getVelocity().y, y.vel[i]) || !isSame(e.getAcceleration().y, y.acc[i]);
+        }
+
+        return differences;
+}
+
+
+int main()
+{
+        const IntegrationKernel kernels[] = { IntegrationKernel::SCALAR, IntegrationKernel::SSE, IntegrationKernel::AVX };
+        const size_t counts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 1003, 10'007 };
+
+        int failures = 0;
+        for(IntegrationKernel kernel : kernels)
+        {
+                if(!EntityIntegrator::isKernelSupported(kernel))
+                {
+                        std::printf("%s kernel: not supported on this cpu, skipped\n", EntityIntegrator::getKernelName(kernel));
+                        continue;
+                }
+
+                for(size_t num : counts)
+                {
+                        size_t differences = compareKernel(kernel, num, (unsigned) num + 1);
+                        if(differences != 0)
+                        {
+                                std::printf("%s kernel: %zu of %zu entities differ from Entity::update()!\n", EntityIntegrator::getKernelName(kernel), differences, num);
+                                ++failures;
+                        }
+                }
+
+                std::printf("%s kernel: checked\n", EntityIntegrator::getKernelName(kernel));
+        }
+
+        return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+
+// Checks that the ticks scheduled for the blocks of a frozen chunk are parked in the chunk: they must not fire while the
+// chunk is frozen, they must be saved with the chunk when it gets unloaded (and written to disk) and they must fire once
+// the chunk has been loaded again and ticks. Cancelling a parked tick (by replacing its block) must remove it.
+//
+
+#include <filesystem>
+#include <cstdio>
+
+#include "world/gameWorld.hpp"
+#include "world/worldGenerator.hpp"
+
+using namespace mc2d;
+
+
+static int s_failures = 0;
+
+
+static void check(bool condition, const char* what)
+{
+        std::printf("%s: %s\n", condition ? "ok    " : "FAILED", what);
+        s_failures += !condition;
+}
+
+
+// Simulates the given number of world ticks
+static void runTicks(GameWorld& world, uint64_t ticksNum)
+{
+        for(uint64_t i = 0; i < ticksNum * STEPS_PER_WORLD_TICK; ++i)
+                world.update();
+}
+
+
+// Moves the main player (one chunk at a time, so that the chunks on its way get loaded) to the given column
+static void movePlayer(GameWorld& world, float x)
+{
+        EntityStore& entities = world.getEntities();
+        EntityHandle player = world.getMainPlayer();
+
+        while(std::abs(entities.getPos(player).x - x) > 1.0f)
+        {
+                const float step = std::clamp(x - entities.getPos(player).x, -(float) Chunk::width, (float) Chunk::width);
+                entities.setPos(player, glm::vec3(entities.getPos(player).x + step, Chunk::height - 2.0f, 0.0f));
+                entities.setVelocity(player, glm::vec3(0.0f));
+                runTicks(world, 1);
+        }
+
+        runTicks(world, 2);
+}
+
+
+// Returns the y coordinate of the first free block above the ground in the given column
+static int getGroundY(const GameWorld& world, int x)
+{
+        int y = Chunk::height - 1;
+        while(y > 0 && world.getBlock(x + 0.5f, y - 0.5f) == BlockType::AIR)
+                --y;
+
+        return y;
+}
+
+
+static const Chunk* findLoadedChunk(const GameWorld& world, int id)
+{
+        auto c = world.getLoadedChunks().find(id);
+        return c != world.getLoadedChunks().end() ? &c->second : nullptr;
+}
+
+
+int main()
+{
+        const std::filesystem::path worldDirPath = std::filesystem::temp_directory_path() / "mc2dFrozenChunkTicksTest";
+        std::filesystem::remove_all(worldDirPath);
+        std::filesystem::create_directories(worldDirPath);
+
+        GameWorld world = WorldGenerator::generateFlatWorld(5);
+        world.setWorldSaveDirectory(worldDirPath);
+
+        // No chunk is kept in memory after it has been unloaded, so the parked ticks go through the chunk file
+        ChunkStreamingSettings settings;
+        settings.cacheBudget = 0;
+        settings.prefetchTime = 0.0f;
+        world.setChunkStreamingSettings(settings);
+        movePlayer(world, Chunk::width / 2.0f);
+
+        const int frozenId = settings.loadRadius;
+        const Chunk* frozen = findLoadedChunk(world, frozenId);
+        check(frozen != nullptr && frozen->tier == ChunkTier::FROZEN, "the chunk at the load radius is frozen");
+        if(frozen == nullptr)
+                return 1;
+
+        // A TNT block ignited in the frozen chunk does not explode while the chunk is frozen
+        const int tntX = frozenId * Chunk::width + 4;
+        const int tntY = getGroundY(world, tntX);
+        world.setBlock(tntX + 0.5f, tntY + 0.5f, BlockType::TNT);
+        check(world.igniteBlock(tntX + 0.5f, tntY + 0.5f), "the TNT block is ignited");
+        check(!world.getTickScheduler().isScheduled(tntX, tntY), "the tick is not in the tick scheduler");
+        check(frozen->scheduledTicks.size() == 1, "the tick is parked in the frozen chunk");
+
+        runTicks(world, TNT_FUSE_TICKS + 10);
+        check(world.getBlock(tntX + 0.5f, tntY + 0.5f) == BlockType::TNT, "the TNT block does not explode in the frozen chunk");
+
+        // Replacing an ignited block cancels its parked tick
+        const int otherX = tntX + 4;
+        const int otherY = getGroundY(world, otherX);
+        world.setBlock(otherX + 0.5f, otherY + 0.5f, BlockType::TNT);
+        world.igniteBlock(otherX + 0.5f, otherY + 0.5f);
+        world.setBlock(otherX + 0.5f, otherY + 0.5f, BlockType::STONE);
+        check(frozen->scheduledTicks.size() == 1, "replacing an ignited block cancels its parked tick");
+
+        // The parked tick is saved with the chunk when it gets unloaded
+        movePlayer(world, -6.0f * Chunk::width);
+        check(findLoadedChunk(world, frozenId) == nullptr, "the frozen chunk has been unloaded");
+        check(world.flushChunkWrites(), "the unloaded chunk has been written");
+
+        // And it fires once the chunk ticks again
+        movePlayer(world, frozenId * Chunk::width + Chunk::width / 2.0f);
+        const Chunk* ticking = findLoadedChunk(world, frozenId);
+        check(ticking != nullptr && ticking->tier == ChunkTier::TICKING, "the chunk has been loaded again and ticks");
+        check(world.getTickScheduler().isScheduled(tntX, tntY), "the parked tick is back in the tick scheduler");
+
+        runTicks(world, TNT_FUSE_TICKS + 10);
+        check(world.getBlock(tntX + 0.5f, tntY + 0.5f) != BlockType::TNT, "the TNT block explodes once the chunk ticks");
+
+        world.flushChunkWrites();
+        std::error_code error;
+        std::filesystem::remove_all(worldDirPath, error);
+        return s_failures == 0 ? 0 : 1;
+}
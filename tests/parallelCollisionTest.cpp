@@ -0,0 +1,104 @@
+// Checks that resolving the entity collisions in parallel gives the same world as resolving them on a single thread: two
+// copies of the same world, full of entities that keep crossing the chunk borders, are simulated one with the task pool and
+// one without it, and the positions of the entities and the chunks that contain them must match bit for bit.
+//
+
+#include <cstdio>
+#include <cstring>
+
+#include "world/gameWorld.hpp"
+#include "world/worldGenerator.hpp"
+
+using namespace mc2d;
+
+
+static int s_failures = 0;
+
+
+static void check(bool condition, const char* what)
+{
+        std::printf("%s: %s\n", condition ? "ok    " : "FAILED", what);
+        s_failures += !condition;
+}
+
+
+// Fills the ticking chunks of the world with entities that move in random directions
+static void addEntities(GameWorld& world, int simulationRadius, size_t entitiesNum)
+{
+        EntityStore& entities = world.getEntities();
+        uint32_t rng = 12345;
+        auto next = [&rng]() { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+        const float minX = -simulationRadius * (float) Chunk::width;
+        const float rangeX = (2 * simulationRadius + 1) * (float) Chunk::width - 1.0f;
+        for(size_t i = 0; i < entitiesNum; ++i)
+        {
+                const float x = minX + rangeX * (next() % 10000) / 10000.0f;
+                const float y = Chunk::height - 2.0f - (next() % 8);
+                EntityHandle h = world.addEntity(Entity(glm::vec3(x, y, 0.0f), 50.0f, EntityType::CHICKEN));
+                if(h != INVALID_ENTITY_HANDLE)
+                        entities.setVelocity(h, glm::vec3(((int) (next() % 200) - 100) / 5.0f, 0.0f, 0.0f));
+        }
+}
+
+
+static bool haveSameEntities(const GameWorld& a, const GameWorld& b)
+{
+        const EntityStore& entitiesA = a.getEntities();
+        const EntityStore& entitiesB = b.getEntities();
+        if(a.getLoadedChunks().size() != b.getLoadedChunks().size())
+                return false;
+
+        for(auto ca = a.getLoadedChunks().begin(), cb = b.getLoadedChunks().begin(); ca != a.getLoadedChunks().end(); ++ca, ++cb)
+        {
+                const std::vector<EntityHandle>& handlesA = ca->second.entityHandles;
+                const std::vector<EntityHandle>& handlesB = cb->second.entityHandles;
+                if(ca->first != cb->first || handlesA.size() != handlesB.size())
+                        return false;
+
+                for(size_t i = 0; i < handlesA.size(); ++i)
+                {
+                        const glm::vec3 posA = entitiesA.getPos(handlesA[i]);
+                        const glm::vec3 posB = entitiesB.getPos(handlesB[i]);
+                        if(std::memcmp(&posA, &posB, sizeof(posA)) != 0)
+                                return false;
+                }
+        }
+
+        return true;
+}
+
+
+int main()
+{
+        ChunkStreamingSettings settings;
+        settings.simulationRadius = 4;
+        settings.loadRadius = 5;
+        settings.unloadRadius = 6;
+        settings.prefetchTime = 0.0f;
+
+        GameWorld serial = WorldGenerator::generateFlatWorld(5);
+        GameWorld parallel = WorldGenerator::generateFlatWorld(5);
+        serial.getTaskPool().setThreadsNum(0);
+        parallel.getTaskPool().setThreadsNum(4);
+
+        for(GameWorld* world : { &serial, &parallel })
+        {
+                world->setChunkStreamingSettings(settings);
+                world->update();
+                addEntities(*world, settings.simulationRadius, 4000);
+        }
+
+        check(serial.getEntities().getEntitiesNum() == parallel.getEntities().getEntitiesNum(), "both worlds have the same entities");
+
+        bool same = true;
+        for(int step = 0; step < 600 && same; ++step)
+        {
+                serial.update();
+                parallel.update();
+                same = haveSameEntities(serial, parallel);
+        }
+
+        check(same, "the parallel collisions give the same positions and chunks as the serial ones");
+        return s_failures == 0 ? 0 : 1;
+}